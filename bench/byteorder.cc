@@ -0,0 +1,654 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Microbenchmarks for the byteorder routines.
+ *
+ *  Measures every memcpy_bswap* and bswap_inplace* variant, the
+ *  endian macros, and a representative of each fused conversion,
+ *  across buffer sizes, aligned and misaligned pointers, and hot and
+ *  cold caches, and reports throughput in GB/s and cycles per byte.
+ *  The file routines are bound by the disk, so they are not
+ *  measured. Results are printed as a table, and optionally written
+ *  as JSON to compare runs across commits and machines.
+ *
+ *  \synopsis
+ *      preprocessor_bench [--min-bytes N] [--max-bytes N] [--filter SUBSTR]
+ *                         [--json PATH] [--time-ms N]
+ */
+
+#include <pycpp/preprocessor/byteorder.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <pycpp/preprocessor/processor.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(PYCPP_X86) && defined(PYCPP_GNUC)
+#   include <x86intrin.h>
+#   define PYCPP_BENCH_RDTSC 1
+#elif defined(PYCPP_X86) && defined(PYCPP_MSVC)
+#   include <intrin.h>
+#   define PYCPP_BENCH_RDTSC 1
+#endif
+
+#if defined(__VERSION__)
+#   define PYCPP_BENCH_COMPILER __VERSION__
+#else
+#   define PYCPP_BENCH_COMPILER "unknown"
+#endif
+
+// HELPERS
+// -------
+
+/**
+ *  \brief Command-line options.
+ */
+struct options
+{
+    size_t min_bytes = 64;
+    size_t max_bytes = size_t(1) << 30;
+    std::string filter;
+    std::string json;
+    double time_ms = 50;
+};
+
+
+/**
+ *  \brief Single measurement of a routine.
+ */
+struct result
+{
+    std::string name;
+    size_t bytes;
+    bool aligned;
+    bool cold;
+    double seconds;
+    double cycles;
+};
+
+
+/**
+ *  \brief Routine converting `bytes` bytes from src into dst.
+ */
+typedef std::function<void(void*, void*, size_t)> routine;
+
+
+/**
+ *  \brief Benchmarked routine and the element size its buffers must
+ *  be a multiple of.
+ */
+struct benchmark
+{
+    std::string name;
+    size_t width;
+    routine run;
+};
+
+
+static uint64_t
+read_cycles()
+noexcept
+{
+#if defined(PYCPP_BENCH_RDTSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+// Sink for scalar benchmarks, so the compiler keeps their results.
+static volatile uint64_t SINK;
+
+
+/**
+ *  \brief Evict the buffers from the cache, by writing a buffer twice
+ *  the size of the last-level cache.
+ */
+static void
+evict_cache(
+    std::vector<uint8_t>& scratch
+)
+{
+    size_t size = 2 * bswap_streaming_threshold();
+    if (scratch.size() < size) {
+        scratch.resize(size);
+    }
+    for (size_t i = 0; i < scratch.size(); i += 64) {
+        scratch[i] += 1;
+    }
+}
+
+// BENCHMARKS
+// ----------
+
+/**
+ *  \brief Benchmark a scalar routine over each element of a buffer.
+ */
+template <typename T, typename F>
+static routine
+scalar(
+    F f
+)
+{
+    return [f](void* dst, void* src, size_t bytes) {
+        auto* d = reinterpret_cast<uint8_t*>(dst);
+        auto* s = reinterpret_cast<const uint8_t*>(src);
+        uint64_t sum = 0;
+        for (size_t i = 0; i + sizeof(T) <= bytes; i += sizeof(T)) {
+            T v;
+            std::memcpy(&v, s + i, sizeof(T));
+            v = f(v);
+            std::memcpy(d + i, &v, sizeof(T));
+            sum += static_cast<uint64_t>(v);
+        }
+        SINK = sum;
+    };
+}
+
+
+/**
+ *  \brief Big-endian UTF-16 text of at least `bytes` bytes.
+ *
+ *  The text is mostly ASCII, with accented letters, CJK characters and
+ *  surrogate pairs mixed in, so the validating conversions run over
+ *  valid text rather than the pattern of the shared source buffer.
+ */
+static const uint8_t*
+utf16_text(
+    size_t bytes
+)
+{
+    static std::vector<uint8_t> text;
+    if (text.size() < bytes + 4) {
+        text.resize(bytes + 4);
+        for (size_t k = 0; 2 * k + 1 < text.size(); ++k) {
+            uint16_t unit = static_cast<uint16_t>('a' + k % 26);
+            if (k % 97 == 0) {
+                unit = 0xD83D;
+            } else if (k % 97 == 1) {
+                unit = 0xDE00;
+            } else if (k % 53 == 0) {
+                unit = 0x4E2D;
+            } else if (k % 31 == 0) {
+                unit = 0x00E9;
+            }
+            text[2 * k] = static_cast<uint8_t>(unit >> 8);
+            text[2 * k + 1] = static_cast<uint8_t>(unit);
+        }
+    }
+    return text.data();
+}
+
+
+/**
+ *  \brief Ascending selection of every other element, at random, out
+ *  of `count` elements.
+ */
+static const uint32_t*
+selection(
+    size_t count
+)
+{
+    static std::vector<uint32_t> indices;
+    if (indices.size() != count / 2) {
+        indices.resize(count / 2);
+        uint32_t state = 1;
+        for (size_t k = 0; k < indices.size(); ++k) {
+            state = state * 1664525u + 1013904223u;
+            indices[k] = static_cast<uint32_t>(2 * k + (state >> 31));
+        }
+    }
+    return indices.data();
+}
+
+
+/**
+ *  \brief Split `bytes` bytes at `buf` into 16 segments, alternating
+ *  between 3 and 1 parts in 32 of the buffer when `skewed`, so the
+ *  segments of the source and destination split elements apart.
+ */
+static std::vector<bswap_iovec>
+iovecs(
+    void* buf,
+    size_t bytes,
+    bool skewed
+)
+{
+    std::vector<bswap_iovec> list;
+    auto* p = static_cast<uint8_t*>(buf);
+    size_t offset = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        size_t length = skewed ? bytes * (i % 2 == 0 ? 3 : 1) / 32 : bytes / 16;
+        if (i == 15) {
+            length = bytes - offset;
+        }
+        list.push_back({p + offset, length});
+        offset += length;
+    }
+    return list;
+}
+
+
+static std::vector<benchmark>
+make_benchmarks()
+{
+    std::vector<benchmark> list;
+
+    // CONVERSION
+    for (int width: {2, 4, 8, 16}) {
+        list.push_back({"bswap/" + std::to_string(width), size_t(width), [width](void* dst, void* src, size_t bytes) {
+            auto* d = reinterpret_cast<uint8_t*>(dst);
+            auto* s = reinterpret_cast<uint8_t*>(src);
+            for (size_t i = 0; i < bytes; i += width) {
+                bswap(d + i, s + i, width);
+            }
+        }});
+    }
+    list.push_back({"memcpy_bswap16", 2, [](void* d, void* s, size_t n) { memcpy_bswap16(d, s, n); }});
+    list.push_back({"memcpy_bswap24", 3, [](void* d, void* s, size_t n) { memcpy_bswap24(d, s, n); }});
+    list.push_back({"memcpy_bswap32", 4, [](void* d, void* s, size_t n) { memcpy_bswap32(d, s, n); }});
+    list.push_back({"memcpy_bswap64", 8, [](void* d, void* s, size_t n) { memcpy_bswap64(d, s, n); }});
+    list.push_back({"memcpy_bswap128", 16, [](void* d, void* s, size_t n) { memcpy_bswap128(d, s, n); }});
+    for (int width: {3, 5, 6, 7, 12, 24, 32}) {
+        list.push_back({"memcpy_bswap/" + std::to_string(width), size_t(width), [width](void* d, void* s, size_t n) {
+            memcpy_bswap(d, s, n, width);
+        }});
+    }
+    list.push_back({"bswap_inplace16", 2, [](void* d, void*, size_t n) { bswap_inplace16(d, n); }});
+    list.push_back({"bswap_inplace24", 3, [](void* d, void*, size_t n) { bswap_inplace24(d, n); }});
+    list.push_back({"bswap_inplace32", 4, [](void* d, void*, size_t n) { bswap_inplace32(d, n); }});
+    list.push_back({"bswap_inplace64", 8, [](void* d, void*, size_t n) { bswap_inplace64(d, n); }});
+    list.push_back({"bswap_inplace128", 16, [](void* d, void*, size_t n) { bswap_inplace128(d, n); }});
+    list.push_back({"bswap_inplace/6", 6, [](void* d, void*, size_t n) { bswap_inplace(d, n, 6); }});
+    list.push_back({"memcpy_bswap_parallel/8", 8, [](void* d, void* s, size_t n) { memcpy_bswap_parallel(d, s, n, 8); }});
+    list.push_back({"memcpy_bswap_stream/8", 8, [](void* d, void* s, size_t n) { memcpy_bswap_stream(d, s, n, 8); }});
+
+    // SCATTER/GATHER
+    list.push_back({"memcpy_bswapv16", 2, [](void* d, void* s, size_t n) {
+        std::vector<bswap_iovec> dst = iovecs(d, n, false);
+        std::vector<bswap_iovec> src = iovecs(s, n, true);
+        memcpy_bswapv16(dst.data(), dst.size(), src.data(), src.size());
+    }});
+    list.push_back({"memcpy_bswapv32", 4, [](void* d, void* s, size_t n) {
+        std::vector<bswap_iovec> dst = iovecs(d, n, false);
+        std::vector<bswap_iovec> src = iovecs(s, n, true);
+        memcpy_bswapv32(dst.data(), dst.size(), src.data(), src.size());
+    }});
+    list.push_back({"memcpy_bswapv64", 8, [](void* d, void* s, size_t n) {
+        std::vector<bswap_iovec> dst = iovecs(d, n, false);
+        std::vector<bswap_iovec> src = iovecs(s, n, true);
+        memcpy_bswapv64(dst.data(), dst.size(), src.data(), src.size());
+    }});
+    list.push_back({"memcpy_bswapv/6", 6, [](void* d, void* s, size_t n) {
+        std::vector<bswap_iovec> dst = iovecs(d, n, false);
+        std::vector<bswap_iovec> src = iovecs(s, n, true);
+        memcpy_bswapv(dst.data(), dst.size(), src.data(), src.size(), 6);
+    }});
+    list.push_back({"bswap_inplacev/8", 8, [](void* d, void*, size_t n) {
+        std::vector<bswap_iovec> buf = iovecs(d, n, true);
+        bswap_inplacev(buf.data(), buf.size(), 8);
+    }});
+
+    // MACROS
+    list.push_back({"htobe16", 2, scalar<uint16_t>([](uint16_t v) { return static_cast<uint16_t>(htobe16(v)); })});
+    list.push_back({"be16toh", 2, scalar<uint16_t>([](uint16_t v) { return static_cast<uint16_t>(be16toh(v)); })});
+    list.push_back({"htobe32", 4, scalar<uint32_t>([](uint32_t v) { return static_cast<uint32_t>(htobe32(v)); })});
+    list.push_back({"be32toh", 4, scalar<uint32_t>([](uint32_t v) { return static_cast<uint32_t>(be32toh(v)); })});
+    list.push_back({"htobe64", 8, scalar<uint64_t>([](uint64_t v) { return static_cast<uint64_t>(htobe64(v)); })});
+    list.push_back({"be64toh", 8, scalar<uint64_t>([](uint64_t v) { return static_cast<uint64_t>(be64toh(v)); })});
+    list.push_back({"htole16", 2, scalar<uint16_t>([](uint16_t v) { return static_cast<uint16_t>(htole16(v)); })});
+    list.push_back({"le16toh", 2, scalar<uint16_t>([](uint16_t v) { return static_cast<uint16_t>(le16toh(v)); })});
+    list.push_back({"htole32", 4, scalar<uint32_t>([](uint32_t v) { return static_cast<uint32_t>(htole32(v)); })});
+    list.push_back({"le32toh", 4, scalar<uint32_t>([](uint32_t v) { return static_cast<uint32_t>(le32toh(v)); })});
+    list.push_back({"htole64", 8, scalar<uint64_t>([](uint64_t v) { return static_cast<uint64_t>(htole64(v)); })});
+    list.push_back({"le64toh", 8, scalar<uint64_t>([](uint64_t v) { return static_cast<uint64_t>(le64toh(v)); })});
+    list.push_back({"memcpy_htobe16", 2, [](void* d, void* s, size_t n) { memcpy_htobe16(d, s, n); }});
+    list.push_back({"memcpy_be24toh", 3, [](void* d, void* s, size_t n) { memcpy_be24toh(d, s, n); }});
+    list.push_back({"memcpy_htobe32", 4, [](void* d, void* s, size_t n) { memcpy_htobe32(d, s, n); }});
+    list.push_back({"memcpy_be64toh", 8, [](void* d, void* s, size_t n) { memcpy_be64toh(d, s, n); }});
+    list.push_back({"memcpy_be128toh", 16, [](void* d, void* s, size_t n) { memcpy_be128toh(d, s, n); }});
+    list.push_back({"memcpy_htole16", 2, [](void* d, void* s, size_t n) { memcpy_htole16(d, s, n); }});
+    list.push_back({"memcpy_le32toh", 4, [](void* d, void* s, size_t n) { memcpy_le32toh(d, s, n); }});
+    list.push_back({"memcpy_htole64", 8, [](void* d, void* s, size_t n) { memcpy_htole64(d, s, n); }});
+    list.push_back({"be32toh_inplace", 4, [](void* d, void*, size_t n) { be32toh_inplace(d, n); }});
+
+    // LOAD/STORE
+    list.push_back({"load_be32", 4, [](void* dst, void* src, size_t bytes) {
+        auto* d = reinterpret_cast<uint8_t*>(dst);
+        auto* s = reinterpret_cast<const uint8_t*>(src);
+        for (size_t i = 0; i < bytes; i += 4) {
+            store_le32(d + i, load_be32(s + i));
+        }
+    }});
+    list.push_back({"load_be64", 8, [](void* dst, void* src, size_t bytes) {
+        auto* d = reinterpret_cast<uint8_t*>(dst);
+        auto* s = reinterpret_cast<const uint8_t*>(src);
+        for (size_t i = 0; i < bytes; i += 8) {
+            store_le64(d + i, load_be64(s + i));
+        }
+    }});
+
+    // FLOATS
+    list.push_back({"memcpy_betoh_f32", 4, [](void* d, void* s, size_t n) { memcpy_betoh_f32(d, s, n); }});
+    list.push_back({"memcpy_betoh_f64", 8, [](void* d, void* s, size_t n) { memcpy_betoh_f64(d, s, n); }});
+
+    // CHECKSUMS
+    list.push_back({"memcpy_bswap16_crc32c", 2, [](void* d, void* s, size_t n) {
+        SINK = memcpy_bswap16_crc32c(d, s, n);
+    }});
+    list.push_back({"memcpy_bswap32_crc32c", 4, [](void* d, void* s, size_t n) {
+        SINK = memcpy_bswap32_crc32c(d, s, n);
+    }});
+    list.push_back({"memcpy_bswap64_crc32c", 8, [](void* d, void* s, size_t n) {
+        SINK = memcpy_bswap64_crc32c(d, s, n);
+    }});
+    list.push_back({"memcpy_bswap_crc32c/6", 6, [](void* d, void* s, size_t n) {
+        SINK = memcpy_bswap_crc32c(d, s, n, 6);
+    }});
+
+    // WIDENING
+    // Destinations are twice the source size, so convert half the buffer.
+    list.push_back({"convert_be16_to_i32", 4, [](void* d, void* s, size_t n) {
+        convert_be16_to_i32(reinterpret_cast<int32_t*>(d), s, n / 4);
+    }});
+    list.push_back({"convert_be16_to_f32", 4, [](void* d, void* s, size_t n) {
+        convert_be16_to_f32(reinterpret_cast<float*>(d), s, n / 4);
+    }});
+    list.push_back({"convert_bef16_to_f32", 4, [](void* d, void* s, size_t n) {
+        convert_bef16_to_f32(reinterpret_cast<float*>(d), s, n / 4);
+    }});
+    list.push_back({"convert_bebf16_to_f32", 4, [](void* d, void* s, size_t n) {
+        convert_bebf16_to_f32(reinterpret_cast<float*>(d), s, n / 4);
+    }});
+
+    // UTF-16
+    list.push_back({"memcpy_betoh_utf16", 2, [](void* d, void*, size_t n) {
+        SINK = memcpy_betoh_utf16(d, utf16_text(n), n / 2);
+    }});
+    list.push_back({"convert_utf16be_to_utf8", 2, [](void*, void*, size_t n) {
+        // UTF-8 takes up to 3 bytes per code unit.
+        static std::vector<char> out;
+        if (out.size() < 3 * n / 2) {
+            out.resize(3 * n / 2);
+        }
+        size_t written;
+        SINK = convert_utf16be_to_utf8(out.data(), utf16_text(n), n / 2, &written);
+    }});
+
+    // BYTE PLANES
+    for (int width: {2, 4, 8, 16}) {
+        list.push_back({"byte_shuffle/" + std::to_string(width), size_t(width), [width](void* d, void* s, size_t n) {
+            byte_shuffle(d, s, n, width);
+        }});
+        list.push_back({"byte_unshuffle/" + std::to_string(width), size_t(width), [width](void* d, void* s, size_t n) {
+            byte_unshuffle(d, s, n, width);
+        }});
+    }
+
+    // BATCHES
+    // 32 columns of 2, 4, and 8-byte elements, converted one call per
+    // column and in one batch.
+    auto columns = [](void* d, void* s, size_t n) {
+        std::vector<bswap_column> list;
+        size_t bytes = n / 32;
+        for (size_t i = 0; i < 32; ++i) {
+            int width = 2 << (i % 3);
+            list.push_back({static_cast<uint8_t*>(d) + i * bytes, static_cast<uint8_t*>(s) + i * bytes, bytes, width});
+        }
+        return list;
+    };
+    list.push_back({"memcpy_bswap/columns", 256, [columns](void* d, void* s, size_t n) {
+        for (const bswap_column& column: columns(d, s, n)) {
+            memcpy_bswap(column.dst, const_cast<void*>(column.src), column.bytes, column.width);
+        }
+    }});
+    list.push_back({"memcpy_bswap_batch/columns", 256, [columns](void* d, void* s, size_t n) {
+        std::vector<bswap_column> list = columns(d, s, n);
+        memcpy_bswap_batch(list.data(), list.size(), 1);
+    }});
+
+    // SELECTIONS
+    // Select half the elements, gathered into a temporary then
+    // converted, and gathered and converted in one pass.
+    list.push_back({"gather+memcpy_bswap32", 4, [](void* d, void* s, size_t n) {
+        static std::vector<uint32_t> tmp;
+        const uint32_t* indices = selection(n / 4);
+        tmp.resize(n / 8);
+        for (size_t k = 0; k < tmp.size(); ++k) {
+            std::memcpy(&tmp[k], static_cast<uint8_t*>(s) + size_t(indices[k]) * 4, 4);
+        }
+        memcpy_bswap32(d, tmp.data(), tmp.size() * 4);
+    }});
+    list.push_back({"gather_bswap32", 4, [](void* d, void* s, size_t n) {
+        gather_bswap32(d, s, selection(n / 4), n / 8);
+    }});
+    list.push_back({"gather_bswap64", 8, [](void* d, void* s, size_t n) {
+        gather_bswap64(d, s, selection(n / 8), n / 16);
+    }});
+
+    // RECORDS
+    // u16, u32, u64, double and 2 bytes of padding.
+    static const bswap_field fields[] = {{0, 2}, {2, 4}, {6, 8}, {14, 8}};
+    static bswap_layout* layout = bswap_layout_create(fields, 4, 24);
+    list.push_back({"memcpy_bswap_records/24", 24, [](void* d, void* s, size_t n) {
+        memcpy_bswap_records(d, s, n / 24, layout);
+    }});
+
+    // PERMUTATIONS
+    list.push_back({"memcpy_pdptoh32", 4, [](void* d, void* s, size_t n) {
+        memcpy_pdptoh32(d, s, n);
+    }});
+    list.push_back({"memcpy_fpatoh_f64", 8, [](void* d, void* s, size_t n) {
+        memcpy_fpatoh_f64(d, s, n);
+    }});
+    // Interleaved RGB to BGR.
+    static const uint8_t rgb[] = {2, 1, 0};
+    static bswap_layout* bgr = bswap_permutation_create(rgb, 3);
+    list.push_back({"memcpy_permute/3", 3, [](void* d, void* s, size_t n) {
+        memcpy_permute(d, s, n, bgr);
+    }});
+
+    return list;
+}
+
+// RUNNER
+// ------
+
+/**
+ *  \brief Time a routine, repeating it until `time_ms` elapses, and
+ *  return the fastest repetition.
+ */
+static result
+measure(
+    const benchmark& bench,
+    uint8_t* dst,
+    uint8_t* src,
+    size_t bytes,
+    bool aligned,
+    bool cold,
+    const options& opts,
+    std::vector<uint8_t>& scratch
+)
+{
+    typedef std::chrono::steady_clock clock;
+    result best = {bench.name, bytes, aligned, cold, 1e300, 0};
+
+    // warm up
+    bench.run(dst, src, bytes);
+
+    // The budget includes cache eviction, which otherwise dominates
+    // cold runs over small buffers.
+    auto start = clock::now();
+    double elapsed = 0;
+    int repetitions = 0;
+    while (repetitions < 3 || (elapsed < opts.time_ms / 1000 && repetitions < 1000000)) {
+        if (cold) {
+            evict_cache(scratch);
+        }
+        uint64_t c0 = read_cycles();
+        auto t0 = clock::now();
+        bench.run(dst, src, bytes);
+        auto t1 = clock::now();
+        uint64_t c1 = read_cycles();
+
+        double seconds = std::chrono::duration<double>(t1 - t0).count();
+        elapsed = std::chrono::duration<double>(t1 - start).count();
+        ++repetitions;
+        if (seconds < best.seconds) {
+            best.seconds = seconds;
+            best.cycles = static_cast<double>(c1 - c0);
+        }
+    }
+
+    return best;
+}
+
+
+static void
+print_result(
+    const result& r
+)
+{
+    double gbps = r.bytes / r.seconds / 1e9;
+    std::printf("%-28s %12zu %-10s %-5s %10.3f GB/s", r.name.c_str(), r.bytes,
+        r.aligned ? "aligned" : "misaligned", r.cold ? "cold" : "hot", gbps);
+    if (r.cycles > 0) {
+        std::printf(" %8.3f cycles/B", r.cycles / r.bytes);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+
+static bool
+write_json(
+    const std::string& path,
+    const std::vector<result>& results
+)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    std::fprintf(file, "{\n  \"compiler\": \"%s\",\n", PYCPP_BENCH_COMPILER);
+    std::fprintf(file, "  \"streaming_threshold\": %zu,\n", bswap_streaming_threshold());
+    std::fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const result& r = results[i];
+        std::fprintf(file, "    {\"name\": \"%s\", \"bytes\": %zu, \"aligned\": %s, \"cache\": \"%s\", "
+            "\"seconds\": %.9g, \"gbps\": %.6g, ",
+            r.name.c_str(), r.bytes, r.aligned ? "true" : "false", r.cold ? "cold" : "hot",
+            r.seconds, r.bytes / r.seconds / 1e9);
+        if (r.cycles > 0) {
+            std::fprintf(file, "\"cycles_per_byte\": %.6g}", r.cycles / r.bytes);
+        } else {
+            std::fprintf(file, "\"cycles_per_byte\": null}");
+        }
+        std::fprintf(file, "%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+
+    return std::fclose(file) == 0;
+}
+
+
+static bool
+parse_options(
+    int argc,
+    char** argv,
+    options& opts
+)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        } else if (arg == "--min-bytes") {
+            opts.min_bytes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--max-bytes") {
+            opts.max_bytes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--filter") {
+            opts.filter = argv[++i];
+        } else if (arg == "--json") {
+            opts.json = argv[++i];
+        } else if (arg == "--time-ms") {
+            opts.time_ms = std::strtod(argv[++i], nullptr);
+        } else {
+            return false;
+        }
+    }
+    return opts.min_bytes > 0 && opts.min_bytes <= opts.max_bytes;
+}
+
+// MAIN
+// ----
+
+int
+main(
+    int argc,
+    char** argv
+)
+{
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: %s [--min-bytes N] [--max-bytes N] [--filter SUBSTR] "
+            "[--json PATH] [--time-ms N]\n", argv[0]);
+        return 2;
+    }
+
+    // Buffers are padded for the misaligned offset, and the sources
+    // are filled so float conversions see ordinary values.
+    size_t capacity = opts.max_bytes + 64;
+    std::vector<uint8_t> src_buffer, dst_buffer, scratch;
+    try {
+        src_buffer.resize(capacity);
+        dst_buffer.resize(capacity);
+    } catch (const std::bad_alloc&) {
+        std::fprintf(stderr, "unable to allocate %zu bytes, lower --max-bytes\n", 2 * capacity);
+        return 1;
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+        src_buffer[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+    uintptr_t address = reinterpret_cast<uintptr_t>(src_buffer.data());
+    uint8_t* src = src_buffer.data() + (64 - address % 64) % 64;
+    address = reinterpret_cast<uintptr_t>(dst_buffer.data());
+    uint8_t* dst = dst_buffer.data() + (64 - address % 64) % 64;
+
+    std::vector<result> results;
+    for (const benchmark& bench: make_benchmarks()) {
+        if (!opts.filter.empty() && bench.name.find(opts.filter) == std::string::npos) {
+            continue;
+        }
+        for (size_t size = opts.min_bytes; size <= opts.max_bytes; size *= 4) {
+            size_t bytes = size - size % bench.width;
+            if (bytes == 0) {
+                continue;
+            }
+            for (bool aligned: {true, false}) {
+                for (bool cold: {false, true}) {
+                    size_t offset = aligned ? 0 : 1;
+                    results.push_back(measure(bench, dst + offset, src + offset, bytes, aligned, cold, opts, scratch));
+                    print_result(results.back());
+                }
+            }
+        }
+    }
+
+    if (!opts.json.empty() && !write_json(opts.json, results)) {
+        std::fprintf(stderr, "unable to write %s\n", opts.json.c_str());
+        return 1;
+    }
+
+    return 0;
+}
@@ -2,11 +2,85 @@
 //  :license: Public Domain/MIT, see licenses/mit.md for more details.
 
 #include <pycpp/preprocessor/byteorder.h>
+#include <pycpp/preprocessor/cache.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <pycpp/preprocessor/compiler_traits.h>
+#include <pycpp/preprocessor/os.h>
+#include <pycpp/preprocessor/processor.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
 #include <climits>
+#include <condition_variable>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <mutex>
+#include <new>
+#include <numeric>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#if defined(PYCPP_OS_POSIX)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <sys/uio.h>
+#   include <unistd.h>
+#endif
+// The pipelines use io_uring through the raw system calls, so they
+// do not depend on liburing. Define PYCPP_BYTEORDER_NO_IO_URING to
+// always read on a thread instead.
+#if defined(PYCPP_OS_LINUX) && !defined(PYCPP_BYTEORDER_NO_IO_URING) && PYCPP_HAS_INCLUDE(<linux/io_uring.h>)
+#   include <linux/io_uring.h>
+#   include <sys/syscall.h>
+#   if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#       define PYCPP_BYTEORDER_IO_URING 1
+#   endif
+#endif
+
+// SIMD
+// ----
+
+// Vector kernels are compiled with per-function target attributes,
+// so the translation unit itself does not require `-mavx2` or
+// similar flags, and the kernel is chosen at runtime from the
+// features reported by the CPU.
+#if defined(PYCPP_X86) && defined(PYCPP_GNUC)
+#   define PYCPP_BYTEORDER_X86 1
+#   define PYCPP_BYTEORDER_TARGET(x) __attribute__((target(x)))
+#   include <cpuid.h>
+#   include <immintrin.h>
+#elif defined(PYCPP_X86) && defined(PYCPP_MSVC)
+#   define PYCPP_BYTEORDER_X86 1
+#   define PYCPP_BYTEORDER_TARGET(x)
+#   include <intrin.h>
+#   include <immintrin.h>
+#elif defined(PYCPP_ARM) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+// NEON is mandatory on AArch64, and on 32-bit ARM we only use it
+// when the compiler already targets it.
+#   define PYCPP_BYTEORDER_NEON 1
+#   include <arm_neon.h>
+#endif
+
+// Fully unroll short loops over arrays of registers, which compilers
+// otherwise keep on the stack.
+#if defined(PYCPP_CLANG)
+#   define PYCPP_BYTEORDER_UNROLL _Pragma("unroll")
+#elif defined(PYCPP_GNUC) && PYCPP_GNUC_MAJOR_VERSION >= 8
+#   define PYCPP_BYTEORDER_UNROLL _Pragma("GCC unroll 16")
+#else
+#   define PYCPP_BYTEORDER_UNROLL
+#endif
+
+#if defined(PYCPP_ARM) && defined(__ARM_FEATURE_CRC32)
+// The ARMv8 CRC extension is optional, so it is only used when the
+// compiler already targets it.
+#   define PYCPP_BYTEORDER_ARM_CRC 1
+#   include <arm_acle.h>
+#endif
 
 // HELPERS
 // -------
@@ -39,150 +113,6855 @@ noexcept
     }
 }
 
-// FUNCTIONS
-// ---------
 
+/**
+ *  \brief Scalar byteswap of a single element of `Width` bytes.
+ *
+ *  Uses memcpy for the loads and stores, so neither pointer needs
+ *  to be aligned, and loads before storing, so `dst` may equal `src`.
+ */
+template <int Width>
+struct bswap_element;
 
-void
-bswap(
-    void* buf,
-    int width
+
+template <>
+struct bswap_element<2>
+{
+    static void
+    swap(
+        uint8_t* dst,
+        const uint8_t* src
+    )
+    noexcept
+    {
+        uint16_t v;
+        std::memcpy(&v, src, 2);
+        v = pycpp::byteswap(v);
+        std::memcpy(dst, &v, 2);
+    }
+};
+
+
+template <>
+struct bswap_element<4>
+{
+    static void
+    swap(
+        uint8_t* dst,
+        const uint8_t* src
+    )
+    noexcept
+    {
+        uint32_t v;
+        std::memcpy(&v, src, 4);
+        v = pycpp::byteswap(v);
+        std::memcpy(dst, &v, 4);
+    }
+};
+
+
+template <>
+struct bswap_element<8>
+{
+    static void
+    swap(
+        uint8_t* dst,
+        const uint8_t* src
+    )
+    noexcept
+    {
+        uint64_t v;
+        std::memcpy(&v, src, 8);
+        v = pycpp::byteswap(v);
+        std::memcpy(dst, &v, 8);
+    }
+};
+
+
+template <>
+struct bswap_element<16>
+{
+    static void
+    swap(
+        uint8_t* dst,
+        const uint8_t* src
+    )
+    noexcept
+    {
+        uint64_t lo, hi;
+        std::memcpy(&lo, src, 8);
+        std::memcpy(&hi, src + 8, 8);
+        lo = pycpp::byteswap(lo);
+        hi = pycpp::byteswap(hi);
+        std::memcpy(dst, &hi, 8);
+        std::memcpy(dst + 8, &lo, 8);
+    }
+};
+
+
+/**
+ *  \brief Scalar byteswap of each `Width`-byte element from src into dst.
+ */
+template <int Width>
+static void
+bswap_scalar(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
 )
 noexcept
 {
-    bswap_impl(buf, width);
+    size_t n = bytes / Width;
+    for (size_t i = 0; i < n; ++i) {
+        bswap_element<Width>::swap(dst + i * Width, src + i * Width);
+    }
 }
 
 
-void
-bswap(
-    void* dst,
-    void* src,
-    int width
+/**
+ *  \brief Scalar byteswap of each element of a runtime width.
+ */
+static void
+bswap_scalar(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes,
+    size_t width
 )
 noexcept
 {
-    if (src != dst) {
-        std::memcpy(dst, src, width);
+    size_t n = bytes - bytes % width;
+    for (size_t i = 0; i < n; i += width) {
+        if (dst == src) {
+            bswap_impl(dst + i, static_cast<int>(width));
+        } else {
+            for (size_t j = 0; j < width; ++j) {
+                dst[i + j] = src[i + width - 1 - j];
+            }
+        }
     }
-    bswap(dst, width);
 }
 
+// MASKS
+// -----
 
-void
-memcpy_bswap16(
-    void* dst,
-    void* src,
+/**
+ *  \brief Precomputed shuffle for elements that do not evenly
+ *  divide a vector register.
+ *
+ *  Each 16-byte lane holds `step` bytes of whole elements, and the
+ *  trailing bytes of the lane map to themselves, so a store of the
+ *  full lane writes back the unmodified source bytes, which the
+ *  next, overlapping iteration then overwrites. `vector` and
+ *  `vector_step` are the same for a full 64-byte register.
+ */
+struct shuffle_mask
+{
+    alignas(64) uint8_t vector[64];
+    alignas(16) uint8_t lane[16];
+    size_t step;
+    size_t vector_step;
+};
+
+
+/**
+ *  \brief Shuffle masks for byteswapping every width below 16 bytes.
+ */
+struct shuffle_table
+{
+    shuffle_mask masks[16];
+};
+
+
+/**
+ *  \brief Build the shuffle mask for records of at most 16 bytes,
+ *  from the source byte of each byte in a record.
+ */
+static void
+make_record_mask(
+    shuffle_mask& mask,
+    const uint8_t* permutation,
+    size_t record_size
+)
+noexcept
+{
+    mask.step = 16 / record_size * record_size;
+    for (size_t j = 0; j < 16; ++j) {
+        size_t k = j - j % record_size;
+        mask.lane[j] = static_cast<uint8_t>(j < mask.step ? k + permutation[j % record_size] : j);
+    }
+
+    mask.vector_step = 64 / record_size * record_size;
+    for (size_t j = 0; j < 64; ++j) {
+        size_t k = j - j % record_size;
+        mask.vector[j] = static_cast<uint8_t>(j < mask.vector_step ? k + permutation[j % record_size] : j);
+    }
+}
+
+
+/**
+ *  \brief Build the shuffle mask for a byteswap, the permutation
+ *  reversing each element.
+ */
+static void
+make_shuffle_mask(
+    shuffle_mask& mask,
+    size_t width
+)
+noexcept
+{
+    uint8_t permutation[16];
+    for (size_t j = 0; j < width; ++j) {
+        permutation[j] = static_cast<uint8_t>(width - 1 - j);
+    }
+    make_record_mask(mask, permutation, width);
+}
+
+
+static shuffle_table
+make_shuffle_table()
+noexcept
+{
+    shuffle_table table;
+    for (size_t width = 1; width < 16; ++width) {
+        make_shuffle_mask(table.masks[width], width);
+    }
+    return table;
+}
+
+
+/**
+ *  \brief Get the shuffle mask for a width in `[1, 16)`.
+ */
+static const shuffle_mask&
+shuffle_masks(
+    size_t width
+)
+noexcept
+{
+    static const shuffle_table table = make_shuffle_table();
+    return table.masks[width];
+}
+
+
+/**
+ *  \brief Shuffle for 16 bytes at `offset` of a record wider than a lane.
+ *
+ *  Windows tile the record without splitting a field, and bytes past
+ *  the window map to themselves, like the trailing bytes of a
+ *  `shuffle_mask`.
+ */
+struct record_window
+{
+    uint8_t lane[16];
+    size_t offset;
+};
+
+// KERNELS
+// -------
+
+/**
+ *  \brief Vector kernel, which processes a prefix of the buffer.
+ *
+ *  Returns the number of bytes processed, which is always a multiple
+ *  of the element width. The caller handles the remaining tail.
+ *  Kernels load every vector before storing to the same offset,
+ *  so they also byteswap in-place when `dst` equals `src`.
+ */
+typedef size_t (*bswap_kernel)(uint8_t*, const uint8_t*, size_t);
+
+/**
+ *  \brief Vector kernel for widths below 16 bytes, using a shuffle mask.
+ */
+typedef size_t (*shuffle_kernel)(uint8_t*, const uint8_t*, size_t, const shuffle_mask&);
+
+/**
+ *  \brief Vector kernel for widths above 16 bytes.
+ */
+typedef size_t (*wide_kernel)(uint8_t*, const uint8_t*, size_t, size_t);
+
+/**
+ *  \brief Vector kernel for records wider than 16 bytes.
+ *
+ *  Applies every window to each of `records` records, and returns the
+ *  number of records processed. The caller ensures the last window of
+ *  the last record can be loaded.
+ */
+typedef size_t (*record_kernel)(uint8_t*, const uint8_t*, size_t, size_t, const record_window*, size_t);
+
+
+template <int Width>
+static size_t
+bswap_none(
+    uint8_t*,
+    const uint8_t*,
+    size_t
+)
+noexcept
+{
+    return 0;
+}
+
+
+static size_t
+shuffle_none(
+    uint8_t*,
+    const uint8_t*,
+    size_t,
+    const shuffle_mask&
+)
+noexcept
+{
+    return 0;
+}
+
+
+static size_t
+wide_none(
+    uint8_t*,
+    const uint8_t*,
+    size_t,
+    size_t
+)
+noexcept
+{
+    return 0;
+}
+
+
+static size_t
+record_none(
+    uint8_t*,
+    const uint8_t*,
+    size_t,
+    size_t,
+    const record_window*,
+    size_t
+)
+noexcept
+{
+    return 0;
+}
+
+
+#if defined(PYCPP_BYTEORDER_X86)
+
+// PSHUFB masks reversing each 2, 4, 8, or 16-byte element, repeated
+// for every 16-byte lane of a 512-bit register.
+alignas(64) static const uint8_t BSWAP16_MASK[64] = {
+    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14
+};
+alignas(64) static const uint8_t BSWAP32_MASK[64] = {
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+};
+alignas(64) static const uint8_t BSWAP64_MASK[64] = {
+    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+};
+// PSHUFB mask reversing 4 whole 24-bit samples in the low 12 bytes
+// of each lane, with the trailing 4 bytes mapped to themselves.
+alignas(64) static const uint8_t BSWAP24_MASK[64] = {
+    2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15,
+    2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15,
+    2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15,
+    2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15
+};
+// VPERMB index reversing 16 whole 24-bit samples in the low 48 bytes.
+alignas(64) static const uint8_t BSWAP24_VBMI_MASK[64] = {
+    2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 17,
+    16, 15, 20, 19, 18, 23, 22, 21, 26, 25, 24, 29, 28, 27, 32, 31,
+    30, 35, 34, 33, 38, 37, 36, 41, 40, 39, 44, 43, 42, 47, 46, 45,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63
+};
+alignas(64) static const uint8_t BSWAP128_MASK[64] = {
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+};
+
+
+template <int Width>
+static inline const uint8_t*
+bswap_mask()
+noexcept
+{
+    return Width == 2 ? BSWAP16_MASK :
+           Width == 4 ? BSWAP32_MASK :
+           Width == 8 ? BSWAP64_MASK : BSWAP128_MASK;
+}
+
+
+template <int Width>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+bswap_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
     size_t bytes
 )
 noexcept
 {
-    // bounds check
-    assert(bytes % 2 == 0 && "Trailing data for memcpy_bswap16.");
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(bswap_mask<Width>()));
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+        __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v0, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), _mm_shuffle_epi8(v1, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 32), _mm_shuffle_epi8(v2, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 48), _mm_shuffle_epi8(v3, mask));
+    }
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask));
+    }
 
-    // copy bytes
-    uint16_t* dst_ = reinterpret_cast<uint16_t*>(dst);
-    uint16_t* src_ = reinterpret_cast<uint16_t*>(src);
-    for (size_t i = 0; i < bytes / 2; ++i) {
-        dst_[i] = bswap16(src_[i]);
+    return i;
+}
+
+
+template <int Width>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+bswap_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    const __m128i mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(bswap_mask<Width>()));
+    const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(bswap_mask<Width>()));
+    size_t i = 0;
+    for (; i + 128 <= bytes; i += 128) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 64));
+        __m256i v3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 96));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v0, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), _mm256_shuffle_epi8(v1, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 64), _mm256_shuffle_epi8(v2, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 96), _mm256_shuffle_epi8(v3, mask));
+    }
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask));
     }
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask128));
+    }
+
+    return i;
 }
 
 
-void
-memcpy_bswap32(
-    void* dst,
-    void* src,
+template <int Width>
+PYCPP_BYTEORDER_TARGET("avx512f,avx512bw")
+static size_t
+bswap_avx512(
+    uint8_t* dst,
+    const uint8_t* src,
     size_t bytes
 )
 noexcept
 {
-    // bounds check
-    assert(bytes % 4 == 0 && "Trailing data for memcpy_bswap32.");
+    const __m128i mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(bswap_mask<Width>()));
+    const __m512i mask = _mm512_load_si512(bswap_mask<Width>());
+    size_t i = 0;
+    for (; i + 256 <= bytes; i += 256) {
+        __m512i v0 = _mm512_loadu_si512(src + i);
+        __m512i v1 = _mm512_loadu_si512(src + i + 64);
+        __m512i v2 = _mm512_loadu_si512(src + i + 128);
+        __m512i v3 = _mm512_loadu_si512(src + i + 192);
+        _mm512_storeu_si512(dst + i, _mm512_shuffle_epi8(v0, mask));
+        _mm512_storeu_si512(dst + i + 64, _mm512_shuffle_epi8(v1, mask));
+        _mm512_storeu_si512(dst + i + 128, _mm512_shuffle_epi8(v2, mask));
+        _mm512_storeu_si512(dst + i + 192, _mm512_shuffle_epi8(v3, mask));
+    }
+    for (; i + 64 <= bytes; i += 64) {
+        __m512i v = _mm512_loadu_si512(src + i);
+        _mm512_storeu_si512(dst + i, _mm512_shuffle_epi8(v, mask));
+    }
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask128));
+    }
 
-    // copy bytes
-    uint32_t* dst_ = reinterpret_cast<uint32_t*>(dst);
-    uint32_t* src_ = reinterpret_cast<uint32_t*>(src);
-    for (size_t i = 0; i < bytes / 4; ++i) {
-        dst_[i] = bswap32(src_[i]);
+    return i;
+}
+
+
+/**
+ *  \brief Reverse each 24-bit sample, 16 samples per iteration.
+ *
+ *  Lanes are loaded at 12-byte offsets, so each holds 4 whole samples,
+ *  and the trailing 4 bytes of a lane are rewritten by the next store.
+ */
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+bswap24_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP24_MASK));
+    size_t i = 0;
+    for (; i + 52 <= bytes; i += 48) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 24));
+        __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 36));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v0, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_shuffle_epi8(v1, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 24), _mm_shuffle_epi8(v2, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 36), _mm_shuffle_epi8(v3, mask));
+    }
+    for (; i + 16 <= bytes; i += 12) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask));
     }
+
+    return i;
 }
 
 
-void
-memcpy_bswap64(
-    void* dst,
-    void* src,
+/**
+ *  \brief Reverse each 24-bit sample, 32 samples per iteration.
+ *
+ *  Each register holds two lanes loaded 12 bytes apart, as in
+ *  `bswap24_ssse3`.
+ */
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+bswap24_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
     size_t bytes
 )
 noexcept
 {
-    // bounds check
-    assert(bytes % 8 == 0 && "Trailing data for memcpy_bswap64.");
+    const __m128i mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP24_MASK));
+    const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(BSWAP24_MASK));
+    size_t i = 0;
+    for (; i + 100 <= bytes; i += 96) {
+        __m256i v[4];
+        for (int j = 0; j < 4; ++j) {
+            const uint8_t* s = src + i + 24 * j;
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 12));
+            v[j] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), mask);
+        }
+        for (int j = 0; j < 4; ++j) {
+            uint8_t* d = dst + i + 24 * j;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm256_castsi256_si128(v[j]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 12), _mm256_extracti128_si256(v[j], 1));
+        }
+    }
+    for (; i + 16 <= bytes; i += 12) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask128));
+    }
 
-    // copy bytes
-    uint64_t* dst_ = reinterpret_cast<uint64_t*>(dst);
-    uint64_t* src_ = reinterpret_cast<uint64_t*>(src);
-    for (size_t i = 0; i < bytes / 8; ++i) {
-        dst_[i] = bswap64(src_[i]);
+    return i;
+}
+
+
+/**
+ *  \brief Reverse each 24-bit sample, 64 samples per iteration.
+ *
+ *  VPERMB reverses 16 whole samples in the low 48 bytes of each
+ *  register, so registers are loaded 48 bytes apart.
+ */
+PYCPP_BYTEORDER_TARGET("avx512f,avx512bw,avx512vbmi")
+static size_t
+bswap24_avx512vbmi(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    const __m128i mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP24_MASK));
+    const __m512i index = _mm512_load_si512(BSWAP24_VBMI_MASK);
+    const __mmask64 all = ~__mmask64(0);
+    size_t i = 0;
+    for (; i + 208 <= bytes; i += 192) {
+        __m512i v0 = _mm512_loadu_si512(src + i);
+        __m512i v1 = _mm512_loadu_si512(src + i + 48);
+        __m512i v2 = _mm512_loadu_si512(src + i + 96);
+        __m512i v3 = _mm512_loadu_si512(src + i + 144);
+        _mm512_storeu_si512(dst + i, _mm512_maskz_permutexvar_epi8(all, index, v0));
+        _mm512_storeu_si512(dst + i + 48, _mm512_maskz_permutexvar_epi8(all, index, v1));
+        _mm512_storeu_si512(dst + i + 96, _mm512_maskz_permutexvar_epi8(all, index, v2));
+        _mm512_storeu_si512(dst + i + 144, _mm512_maskz_permutexvar_epi8(all, index, v3));
+    }
+    for (; i + 64 <= bytes; i += 48) {
+        __m512i v = _mm512_loadu_si512(src + i);
+        _mm512_storeu_si512(dst + i, _mm512_maskz_permutexvar_epi8(all, index, v));
     }
+    for (; i + 16 <= bytes; i += 12) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask128));
+    }
+
+    return i;
 }
 
 
-void
-memcpy_bswap(
-    void* dst,
-    void* src,
-    size_t bytes,
-    int width
+// Distance ahead of the loads to prefetch the source when streaming,
+// far enough to cover the memory latency of buffers beyond the LLC.
+static const size_t STREAM_PREFETCH_DISTANCE = 16 * PYCPP_CACHELINE_SIZE;
+
+
+/**
+ *  \brief Byteswap with non-temporal stores, as `bswap_ssse3`.
+ *
+ *  The destination must be 16-byte aligned. The source is prefetched
+ *  with a non-temporal hint, so neither buffer displaces the cache.
+ */
+template <int Width>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+bswap_stream_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
 )
 noexcept
 {
-    // bounds check
-    assert(bytes % width == 0 && "Trailing data for memcpy_bswap.");
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(bswap_mask<Width>()));
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        _mm_prefetch(reinterpret_cast<const char*>(src + i + STREAM_PREFETCH_DISTANCE), _MM_HINT_NTA);
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+        __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v0, mask));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 16), _mm_shuffle_epi8(v1, mask));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 32), _mm_shuffle_epi8(v2, mask));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 48), _mm_shuffle_epi8(v3, mask));
+    }
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask));
+    }
+    _mm_sfence();
 
-    // copy bytes
-    for (size_t i = 0; i < bytes; i += width) {
-        bswap(dst, src, width);
+    return i;
+}
+
+
+/**
+ *  \brief Byteswap with non-temporal stores, as `bswap_avx2`.
+ *
+ *  The destination must be 32-byte aligned.
+ */
+template <int Width>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+bswap_stream_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    const __m128i mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(bswap_mask<Width>()));
+    const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(bswap_mask<Width>()));
+    size_t i = 0;
+    for (; i + 128 <= bytes; i += 128) {
+        _mm_prefetch(reinterpret_cast<const char*>(src + i + STREAM_PREFETCH_DISTANCE), _MM_HINT_NTA);
+        _mm_prefetch(reinterpret_cast<const char*>(src + i + STREAM_PREFETCH_DISTANCE + 64), _MM_HINT_NTA);
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 64));
+        __m256i v3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v0, mask));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 32), _mm256_shuffle_epi8(v1, mask));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 64), _mm256_shuffle_epi8(v2, mask));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 96), _mm256_shuffle_epi8(v3, mask));
+    }
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask128));
     }
+    _mm_sfence();
+
+    return i;
 }
 
 
-#if defined(NEED_BSWAPXX)
+/**
+ *  \brief Byteswap with non-temporal stores, as `bswap_avx512`.
+ *
+ *  The destination must be 64-byte aligned.
+ */
+template <int Width>
+PYCPP_BYTEORDER_TARGET("avx512f,avx512bw")
+static size_t
+bswap_stream_avx512(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    const __m128i mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(bswap_mask<Width>()));
+    const __m512i mask = _mm512_load_si512(bswap_mask<Width>());
+    size_t i = 0;
+    for (; i + 128 <= bytes; i += 128) {
+        _mm_prefetch(reinterpret_cast<const char*>(src + i + STREAM_PREFETCH_DISTANCE), _MM_HINT_NTA);
+        _mm_prefetch(reinterpret_cast<const char*>(src + i + STREAM_PREFETCH_DISTANCE + 64), _MM_HINT_NTA);
+        __m512i v0 = _mm512_loadu_si512(src + i);
+        __m512i v1 = _mm512_loadu_si512(src + i + 64);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i), _mm512_shuffle_epi8(v0, mask));
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i + 64), _mm512_shuffle_epi8(v1, mask));
+    }
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask128));
+    }
+    _mm_sfence();
+
+    return i;
+}
+
 
-uint16_t
-bswap16(
-    uint16_t i
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+shuffle_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes,
+    const shuffle_mask& mask
 )
 noexcept
 {
-    uint16_t v = i;
-    bswap(&v, 2);
-    return v;
+    const __m128i lane = _mm_load_si128(reinterpret_cast<const __m128i*>(mask.lane));
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += mask.step) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, lane));
+    }
+
+    return i;
 }
 
 
-uint32_t
-bswap32(
-    uint32_t i
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+shuffle_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes,
+    const shuffle_mask& mask
 )
 noexcept
 {
-    uint32_t v = i;
-    bswap(&v, 4);
-    return v;
+    // Each 128-bit lane is loaded from an offset of `step` bytes,
+    // since elements may straddle the lanes of a contiguous load.
+    const __m128i lane = _mm_load_si128(reinterpret_cast<const __m128i*>(mask.lane));
+    const __m256i mask256 = _mm256_broadcastsi128_si256(lane);
+    size_t step = mask.step;
+    size_t i = 0;
+    for (; i + step + 16 <= bytes; i += 2 * step) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + step));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_shuffle_epi8(v, mask256);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + step), _mm256_extracti128_si256(v, 1));
+    }
+    for (; i + 16 <= bytes; i += step) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, lane));
+    }
+
+    return i;
 }
 
 
-uint64_t
-bswap64(
-    uint64_t i
+PYCPP_BYTEORDER_TARGET("avx512f,avx512bw,avx512vbmi")
+static size_t
+shuffle_avx512vbmi(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes,
+    const shuffle_mask& mask
 )
 noexcept
 {
-    uint64_t v = i;
-    bswap(&v, 8);
-    return v;
+    // VPERMB permutes across the full register, so no element
+    // straddles a lane. The zero-masked form avoids GCC's spurious
+    // -Wuninitialized from the unmasked intrinsic.
+    const __m512i index = _mm512_load_si512(mask.vector);
+    const __m128i lane = _mm_load_si128(reinterpret_cast<const __m128i*>(mask.lane));
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += mask.vector_step) {
+        __m512i v = _mm512_loadu_si512(src + i);
+        _mm512_storeu_si512(dst + i, _mm512_maskz_permutexvar_epi8(~__mmask64(0), index, v));
+    }
+    for (; i + 16 <= bytes; i += mask.step) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, lane));
+    }
+
+    return i;
 }
 
-#endif
+
+/**
+ *  \brief Reverse each element wider than 16 bytes.
+ *
+ *  Pairs of 16-byte chunks from either end of the element are loaded
+ *  before being stored in mirrored positions, and a self-mirrored
+ *  middle shorter than a chunk is reversed bytewise, so `dst` may
+ *  equal `src`.
+ */
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+wide_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes,
+    size_t width
+)
+noexcept
+{
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP128_MASK));
+    size_t n = bytes - bytes % width;
+    for (size_t i = 0; i < n; i += width) {
+        uint8_t* d = dst + i;
+        const uint8_t* s = src + i;
+        size_t lo = 0;
+        size_t hi = width - 16;
+        while (lo + 16 <= hi) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + lo));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + hi));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + lo), _mm_shuffle_epi8(b, mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + hi), _mm_shuffle_epi8(a, mask));
+            lo += 16;
+            hi -= 16;
+        }
+
+        size_t middle = hi + 16 - lo;
+        if (middle >= 16) {
+            hi = lo + middle - 16;
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + lo));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + hi));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + lo), _mm_shuffle_epi8(b, mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + hi), _mm_shuffle_epi8(a, mask));
+        } else if (middle > 0) {
+            bswap_scalar(d + lo, s + lo, middle, middle);
+        }
+    }
+
+    return n;
+}
+
+
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+record_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t records,
+    size_t record_size,
+    const record_window* windows,
+    size_t count
+)
+noexcept
+{
+    for (size_t i = 0; i < records; ++i) {
+        uint8_t* d = dst + i * record_size;
+        const uint8_t* s = src + i * record_size;
+        for (size_t j = 0; j < count; ++j) {
+            const record_window& window = windows[j];
+            __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window.lane));
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + window.offset));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + window.offset), _mm_shuffle_epi8(v, mask));
+        }
+    }
+
+    return records;
+}
+
+#endif                  // PYCPP_BYTEORDER_X86
+
+
+#if defined(PYCPP_BYTEORDER_NEON)
+
+static inline uint8x16_t
+neon_rev(
+    uint8x16_t v,
+    std::integral_constant<int, 2>
+)
+noexcept
+{
+    return vrev16q_u8(v);
+}
+
+
+static inline uint8x16_t
+neon_rev(
+    uint8x16_t v,
+    std::integral_constant<int, 4>
+)
+noexcept
+{
+    return vrev32q_u8(v);
+}
+
+
+static inline uint8x16_t
+neon_rev(
+    uint8x16_t v,
+    std::integral_constant<int, 8>
+)
+noexcept
+{
+    return vrev64q_u8(v);
+}
+
+
+static inline uint8x16_t
+neon_rev(
+    uint8x16_t v,
+    std::integral_constant<int, 16>
+)
+noexcept
+{
+    v = vrev64q_u8(v);
+    return vextq_u8(v, v, 8);
+}
+
+
+/**
+ *  \brief Table lookup of each byte of `v`, as PSHUFB.
+ */
+static inline uint8x16_t
+neon_tbl(
+    uint8x16_t v,
+    uint8x16_t index
+)
+noexcept
+{
+#if defined(PYCPP_ARM64)
+    return vqtbl1q_u8(v, index);
+#else
+    uint8x8x2_t table = {{vget_low_u8(v), vget_high_u8(v)}};
+    uint8x8_t lo = vtbl2_u8(table, vget_low_u8(index));
+    uint8x8_t hi = vtbl2_u8(table, vget_high_u8(index));
+    return vcombine_u8(lo, hi);
+#endif
+}
+
+
+template <int Width>
+static size_t
+bswap_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    std::integral_constant<int, Width> width;
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        uint8x16_t v0 = vld1q_u8(src + i);
+        uint8x16_t v1 = vld1q_u8(src + i + 16);
+        uint8x16_t v2 = vld1q_u8(src + i + 32);
+        uint8x16_t v3 = vld1q_u8(src + i + 48);
+        vst1q_u8(dst + i, neon_rev(v0, width));
+        vst1q_u8(dst + i + 16, neon_rev(v1, width));
+        vst1q_u8(dst + i + 32, neon_rev(v2, width));
+        vst1q_u8(dst + i + 48, neon_rev(v3, width));
+    }
+    for (; i + 16 <= bytes; i += 16) {
+        vst1q_u8(dst + i, neon_rev(vld1q_u8(src + i), width));
+    }
+
+    return i;
+}
+
+
+// Distance ahead of the loads to prefetch the source when streaming.
+static const size_t STREAM_PREFETCH_DISTANCE = 16 * PYCPP_CACHELINE_SIZE;
+
+
+/**
+ *  \brief Store 32 bytes with a non-temporal hint where supported.
+ */
+static inline void
+neon_stream_pair(
+    uint8_t* dst,
+    uint8x16_t a,
+    uint8x16_t b
+)
+noexcept
+{
+#if defined(PYCPP_ARM64) && defined(PYCPP_GNUC)
+    __asm__ __volatile__("stnp %q0, %q1, [%2]" : : "w"(a), "w"(b), "r"(dst) : "memory");
+#else
+    vst1q_u8(dst, a);
+    vst1q_u8(dst + 16, b);
+#endif
+}
+
+
+/**
+ *  \brief Byteswap with non-temporal stores, as `bswap_neon`.
+ */
+template <int Width>
+static size_t
+bswap_stream_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    std::integral_constant<int, Width> width;
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+#if defined(PYCPP_GNUC)
+        __builtin_prefetch(src + i + STREAM_PREFETCH_DISTANCE, 0, 0);
+#endif
+        uint8x16_t v0 = vld1q_u8(src + i);
+        uint8x16_t v1 = vld1q_u8(src + i + 16);
+        uint8x16_t v2 = vld1q_u8(src + i + 32);
+        uint8x16_t v3 = vld1q_u8(src + i + 48);
+        neon_stream_pair(dst + i, neon_rev(v0, width), neon_rev(v1, width));
+        neon_stream_pair(dst + i + 32, neon_rev(v2, width), neon_rev(v3, width));
+    }
+    for (; i + 16 <= bytes; i += 16) {
+        vst1q_u8(dst + i, neon_rev(vld1q_u8(src + i), width));
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Reverse each 24-bit sample, 32 samples per iteration.
+ *
+ *  VLD3 splits the samples into planes of their first, middle and last
+ *  bytes, so storing the planes in reverse order swaps them.
+ */
+static size_t
+bswap24_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    size_t i = 0;
+    for (; i + 96 <= bytes; i += 96) {
+        uint8x16x3_t v0 = vld3q_u8(src + i);
+        uint8x16x3_t v1 = vld3q_u8(src + i + 48);
+        std::swap(v0.val[0], v0.val[2]);
+        std::swap(v1.val[0], v1.val[2]);
+        vst3q_u8(dst + i, v0);
+        vst3q_u8(dst + i + 48, v1);
+    }
+    for (; i + 48 <= bytes; i += 48) {
+        uint8x16x3_t v = vld3q_u8(src + i);
+        std::swap(v.val[0], v.val[2]);
+        vst3q_u8(dst + i, v);
+    }
+
+    return i;
+}
+
+
+static size_t
+shuffle_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes,
+    const shuffle_mask& mask
+)
+noexcept
+{
+    const uint8x16_t lane = vld1q_u8(mask.lane);
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += mask.step) {
+        vst1q_u8(dst + i, neon_tbl(vld1q_u8(src + i), lane));
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Reverse each element wider than 16 bytes, as `wide_ssse3`.
+ */
+static size_t
+wide_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t bytes,
+    size_t width
+)
+noexcept
+{
+    std::integral_constant<int, 16> chunk;
+    size_t n = bytes - bytes % width;
+    for (size_t i = 0; i < n; i += width) {
+        uint8_t* d = dst + i;
+        const uint8_t* s = src + i;
+        size_t lo = 0;
+        size_t hi = width - 16;
+        while (lo + 16 <= hi) {
+            uint8x16_t a = vld1q_u8(s + lo);
+            uint8x16_t b = vld1q_u8(s + hi);
+            vst1q_u8(d + lo, neon_rev(b, chunk));
+            vst1q_u8(d + hi, neon_rev(a, chunk));
+            lo += 16;
+            hi -= 16;
+        }
+
+        size_t middle = hi + 16 - lo;
+        if (middle >= 16) {
+            hi = lo + middle - 16;
+            uint8x16_t a = vld1q_u8(s + lo);
+            uint8x16_t b = vld1q_u8(s + hi);
+            vst1q_u8(d + lo, neon_rev(b, chunk));
+            vst1q_u8(d + hi, neon_rev(a, chunk));
+        } else if (middle > 0) {
+            bswap_scalar(d + lo, s + lo, middle, middle);
+        }
+    }
+
+    return n;
+}
+
+
+static size_t
+record_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t records,
+    size_t record_size,
+    const record_window* windows,
+    size_t count
+)
+noexcept
+{
+    for (size_t i = 0; i < records; ++i) {
+        uint8_t* d = dst + i * record_size;
+        const uint8_t* s = src + i * record_size;
+        for (size_t j = 0; j < count; ++j) {
+            const record_window& window = windows[j];
+            uint8x16_t v = vld1q_u8(s + window.offset);
+            vst1q_u8(d + window.offset, neon_tbl(v, vld1q_u8(window.lane)));
+        }
+    }
+
+    return records;
+}
+
+#endif                  // PYCPP_BYTEORDER_NEON
+
+// CRC32C
+// ------
+
+/**
+ *  \brief CRC32C kernel, which updates a CRC without the final inversion.
+ */
+typedef uint32_t (*crc32c_kernel)(uint32_t, const uint8_t*, size_t);
+
+// Reflected Castagnoli polynomial.
+static const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+// Bytes checksummed before byteswapping the same bytes, small enough
+// that the byteswap reads the source from the L1 cache.
+static const size_t CRC32C_BLOCK_SIZE = 4096;
+
+
+/**
+ *  \brief Lookup tables for slicing-by-8.
+ */
+struct crc32c_table
+{
+    uint32_t table[8][256];
+};
+
+
+static crc32c_table
+make_crc32c_table()
+noexcept
+{
+    crc32c_table result;
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; ++j) {
+            crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0 - (crc & 1)));
+        }
+        result.table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int j = 1; j < 8; ++j) {
+            uint32_t crc = result.table[j - 1][i];
+            result.table[j][i] = (crc >> 8) ^ result.table[0][crc & 0xff];
+        }
+    }
+    return result;
+}
+
+
+/**
+ *  \brief Table-driven CRC32C, processing 8 bytes per iteration.
+ */
+static uint32_t
+crc32c_none(
+    uint32_t crc,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    static const crc32c_table tables = make_crc32c_table();
+    const auto& t = tables.table;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        // Little-endian load, since the CRC is reflected.
+        uint32_t lo = crc ^ (uint32_t(src[i]) | uint32_t(src[i + 1]) << 8 |
+                             uint32_t(src[i + 2]) << 16 | uint32_t(src[i + 3]) << 24);
+        crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^
+              t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+              t[3][src[i + 4]] ^ t[2][src[i + 5]] ^
+              t[1][src[i + 6]] ^ t[0][src[i + 7]];
+    }
+    for (; i < bytes; ++i) {
+        crc = (crc >> 8) ^ t[0][(crc ^ src[i]) & 0xff];
+    }
+
+    return crc;
+}
+
+
+#if defined(PYCPP_BYTEORDER_X86)
+
+PYCPP_BYTEORDER_TARGET("sse4.2")
+static uint32_t
+crc32c_sse42(
+    uint32_t crc,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    size_t i = 0;
+#if defined(PYCPP_X86_64)
+    uint64_t crc64 = crc;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t v;
+        std::memcpy(&v, src + i, 8);
+        crc64 = _mm_crc32_u64(crc64, v);
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    for (; i + 4 <= bytes; i += 4) {
+        uint32_t v;
+        std::memcpy(&v, src + i, 4);
+        crc = _mm_crc32_u32(crc, v);
+    }
+    for (; i < bytes; ++i) {
+        crc = _mm_crc32_u8(crc, src[i]);
+    }
+
+    return crc;
+}
+
+#endif                  // PYCPP_BYTEORDER_X86
+
+
+#if defined(PYCPP_BYTEORDER_ARM_CRC)
+
+static uint32_t
+crc32c_arm(
+    uint32_t crc,
+    const uint8_t* src,
+    size_t bytes
+)
+noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t v;
+        std::memcpy(&v, src + i, 8);
+        crc = __crc32cd(crc, v);
+    }
+    for (; i < bytes; ++i) {
+        crc = __crc32cb(crc, src[i]);
+    }
+
+    return crc;
+}
+
+#endif                  // PYCPP_BYTEORDER_ARM_CRC
+
+// DISPATCH
+// --------
+
+/**
+ *  \brief Kernels selected for the host CPU.
+ *
+ *  `alignment` is the store width of the kernels, to which the
+ *  destination is aligned before entering the vector loop.
+ */
+struct bswap_dispatch
+{
+    bswap_kernel swap16;
+    bswap_kernel swap24;
+    bswap_kernel swap32;
+    bswap_kernel swap64;
+    bswap_kernel swap128;
+    bswap_kernel stream16;
+    bswap_kernel stream32;
+    bswap_kernel stream64;
+    bswap_kernel stream128;
+    shuffle_kernel shuffle;
+    wide_kernel wide;
+    record_kernel record;
+    crc32c_kernel crc32c;
+    size_t alignment;
+};
+
+
+#if defined(PYCPP_BYTEORDER_X86)
+
+/**
+ *  \brief Instruction set extensions used by the byteswap kernels.
+ */
+struct cpu_features
+{
+    bool ssse3;
+    bool sse42;
+    bool avx2;
+    bool f16c;
+    bool avx512bw;
+    bool avx512vbmi;
+};
+
+
+static void
+cpuid(
+    unsigned leaf,
+    unsigned subleaf,
+    unsigned* regs
+)
+noexcept
+{
+#if defined(PYCPP_MSVC)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+
+static uint64_t
+xgetbv()
+noexcept
+{
+#if defined(PYCPP_MSVC)
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+
+
+/**
+ *  \brief Detect the CPU features, including OS support for the
+ *  extended register state.
+ */
+static cpu_features
+detect_cpu_features()
+noexcept
+{
+    cpu_features features = {false, false, false, false, false, false};
+    unsigned regs[4];
+
+    cpuid(0, 0, regs);
+    unsigned max_leaf = regs[0];
+    if (max_leaf < 1) {
+        return features;
+    }
+
+    cpuid(1, 0, regs);
+    features.ssse3 = (regs[2] & (1u << 9)) != 0;
+    features.sse42 = (regs[2] & (1u << 20)) != 0;
+    bool osxsave = (regs[2] & (1u << 27)) != 0;
+    bool f16c = (regs[2] & (1u << 29)) != 0;
+    if (!osxsave || max_leaf < 7) {
+        return features;
+    }
+
+    // XCR0 must enable the XMM and YMM state for AVX, and the
+    // opmask and ZMM state for AVX-512.
+    uint64_t xcr0 = xgetbv();
+    bool ymm = (xcr0 & 0x6) == 0x6;
+    bool zmm = (xcr0 & 0xe6) == 0xe6;
+    features.f16c = ymm && f16c;
+
+    cpuid(7, 0, regs);
+    features.avx2 = ymm && (regs[1] & (1u << 5)) != 0;
+    features.avx512bw = zmm && (regs[1] & (1u << 16)) != 0 && (regs[1] & (1u << 30)) != 0;
+    features.avx512vbmi = features.avx512bw && (regs[2] & (1u << 1)) != 0;
+
+    return features;
+}
+
+#endif                  // PYCPP_BYTEORDER_X86
+
+
+static bswap_dispatch
+make_dispatch()
+noexcept
+{
+    bswap_dispatch table = {
+        bswap_none<2>,
+        bswap_none<3>,
+        bswap_none<4>,
+        bswap_none<8>,
+        bswap_none<16>,
+        bswap_none<2>,
+        bswap_none<4>,
+        bswap_none<8>,
+        bswap_none<16>,
+        shuffle_none,
+        wide_none,
+        record_none,
+        crc32c_none,
+        1
+    };
+
+#if defined(PYCPP_BYTEORDER_X86)
+    cpu_features features = detect_cpu_features();
+    if (features.avx512bw) {
+        table = {
+            bswap_avx512<2>, bswap24_avx2, bswap_avx512<4>, bswap_avx512<8>, bswap_avx512<16>,
+            bswap_stream_avx512<2>, bswap_stream_avx512<4>, bswap_stream_avx512<8>, bswap_stream_avx512<16>,
+            shuffle_avx2, wide_ssse3, record_ssse3, crc32c_none, 64
+        };
+    } else if (features.avx2) {
+        table = {
+            bswap_avx2<2>, bswap24_avx2, bswap_avx2<4>, bswap_avx2<8>, bswap_avx2<16>,
+            bswap_stream_avx2<2>, bswap_stream_avx2<4>, bswap_stream_avx2<8>, bswap_stream_avx2<16>,
+            shuffle_avx2, wide_ssse3, record_ssse3, crc32c_none, 32
+        };
+    } else if (features.ssse3) {
+        table = {
+            bswap_ssse3<2>, bswap24_ssse3, bswap_ssse3<4>, bswap_ssse3<8>, bswap_ssse3<16>,
+            bswap_stream_ssse3<2>, bswap_stream_ssse3<4>, bswap_stream_ssse3<8>, bswap_stream_ssse3<16>,
+            shuffle_ssse3, wide_ssse3, record_ssse3, crc32c_none, 16
+        };
+    }
+    if (features.avx512vbmi) {
+        table.swap24 = bswap24_avx512vbmi;
+        table.shuffle = shuffle_avx512vbmi;
+    }
+    if (features.sse42) {
+        table.crc32c = crc32c_sse42;
+    }
+#elif defined(PYCPP_BYTEORDER_NEON)
+    table = {
+        bswap_neon<2>, bswap24_neon, bswap_neon<4>, bswap_neon<8>, bswap_neon<16>,
+        bswap_stream_neon<2>, bswap_stream_neon<4>, bswap_stream_neon<8>, bswap_stream_neon<16>,
+        shuffle_neon, wide_neon, record_neon, crc32c_none, 16
+    };
+#endif
+#if defined(PYCPP_BYTEORDER_ARM_CRC)
+    table.crc32c = crc32c_arm;
+#endif
+
+    return table;
+}
+
+
+/**
+ *  \brief Get the kernels for the host CPU, detected on first use.
+ */
+static const bswap_dispatch&
+dispatch()
+noexcept
+{
+    static const bswap_dispatch table = make_dispatch();
+    return table;
+}
+
+
+/**
+ *  \brief Bulk byteswap of each `Width`-byte element, using the vector
+ *  kernel for the body and scalar swaps for the unaligned head and the tail.
+ */
+template <int Width>
+static void
+memcpy_bswap_vector(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    bswap_kernel kernel,
+    size_t alignment
+)
+noexcept
+{
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    bytes -= bytes % Width;
+
+    // Align the stores when the destination is element-aligned,
+    // otherwise no scalar head can reach an aligned boundary.
+    size_t head = 0;
+    size_t offset = reinterpret_cast<uintptr_t>(d) % alignment;
+    if (offset != 0 && offset % Width == 0) {
+        head = alignment - offset;
+        head = head < bytes ? head : bytes;
+    }
+    bswap_scalar<Width>(d, s, head);
+
+    size_t body = kernel(d + head, s + head, bytes - head);
+    size_t done = head + body;
+    bswap_scalar<Width>(d + done, s + done, bytes - done);
+}
+
+
+/**
+ *  \brief Size of the last-level cache, or 0 if unknown.
+ */
+static size_t
+detect_llc_size()
+noexcept
+{
+    size_t size = 0;
+
+#if defined(PYCPP_BYTEORDER_X86)
+    // Deterministic cache parameters, from leaf 4 on Intel and leaf
+    // 0x8000001D on AMD, with the largest cache taken as the LLC.
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    unsigned max_leaf = regs[0];
+    cpuid(0x80000000, 0, regs);
+    unsigned max_extended = regs[0];
+
+    unsigned leaves[2] = {4, 0x8000001D};
+    bool supported[2] = {max_leaf >= 4, max_extended >= 0x8000001D};
+    for (int j = 0; j < 2 && size == 0; ++j) {
+        for (unsigned index = 0; supported[j] && index < 16; ++index) {
+            cpuid(leaves[j], index, regs);
+            if ((regs[0] & 0x1f) == 0) {
+                break;
+            }
+            size_t ways = (regs[1] >> 22) + 1;
+            size_t partitions = ((regs[1] >> 12) & 0x3ff) + 1;
+            size_t line = (regs[1] & 0xfff) + 1;
+            size_t sets = static_cast<size_t>(regs[2]) + 1;
+            size = std::max(size, ways * partitions * line * sets);
+        }
+    }
+#endif
+
+#if defined(PYCPP_OS_LINUX) && defined(_SC_LEVEL3_CACHE_SIZE)
+    if (size == 0) {
+        long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        size = static_cast<size_t>(std::max(std::max(l3, l2), 0L));
+    }
+#endif
+
+    return size;
+}
+
+
+// Streaming threshold when the LLC size cannot be detected.
+static const size_t STREAM_DEFAULT_THRESHOLD = size_t(1) << 25;
+
+// Explicit streaming threshold, or 0 to use the LLC size.
+static std::atomic<size_t> STREAM_THRESHOLD(0);
+
+
+static size_t
+default_streaming_threshold()
+noexcept
+{
+    static const size_t llc = detect_llc_size();
+    return llc != 0 ? llc : STREAM_DEFAULT_THRESHOLD;
+}
+
+
+/**
+ *  \brief Check if a copy of `bytes` should bypass the cache.
+ */
+static bool
+use_streaming(
+    const void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    return dst != src && bytes >= bswap_streaming_threshold();
+}
+
+
+/**
+ *  \brief Bulk byteswap of each `Width`-byte element, with non-temporal
+ *  stores when `streaming` is set.
+ *
+ *  Streaming kernels require an aligned destination, so a destination
+ *  that is not element-aligned uses the regular kernel.
+ */
+template <int Width>
+static void
+memcpy_bswap_fixed(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    bswap_kernel kernel,
+    bswap_kernel stream,
+    bool streaming
+)
+noexcept
+{
+    const bswap_dispatch& table = dispatch();
+    if (streaming && reinterpret_cast<uintptr_t>(dst) % Width == 0) {
+        kernel = stream;
+    }
+    memcpy_bswap_vector<Width>(dst, src, bytes, kernel, table.alignment);
+}
+
+
+/**
+ *  \brief Bulk byteswap for any element width.
+ *
+ *  Widths of 2, 3, 4, 8, and 16 bytes use the dedicated kernels, narrower
+ *  widths use a precomputed shuffle mask, and wider widths reverse
+ *  16-byte chunks.
+ */
+static void
+memcpy_bswap_width(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    size_t width,
+    bool streaming = false
+)
+noexcept
+{
+    const bswap_dispatch& table = dispatch();
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    size_t done;
+
+    switch (width) {
+        case 1:
+            if (d != s) {
+                std::memcpy(d, s, bytes);
+            }
+            return;
+        case 2:
+            memcpy_bswap_fixed<2>(d, s, bytes, table.swap16, table.stream16, streaming);
+            return;
+        case 3:
+            done = table.swap24(d, s, bytes);
+            bswap_scalar(d + done, s + done, bytes - done, width);
+            return;
+        case 4:
+            memcpy_bswap_fixed<4>(d, s, bytes, table.swap32, table.stream32, streaming);
+            return;
+        case 8:
+            memcpy_bswap_fixed<8>(d, s, bytes, table.swap64, table.stream64, streaming);
+            return;
+        case 16:
+            memcpy_bswap_fixed<16>(d, s, bytes, table.swap128, table.stream128, streaming);
+            return;
+        default:
+            if (width < 16) {
+                done = table.shuffle(d, s, bytes, shuffle_masks(width));
+            } else {
+                done = table.wide(d, s, bytes, width);
+            }
+            bswap_scalar(d + done, s + done, bytes - done, width);
+            return;
+    }
+}
+
+// RECORDS
+// -------
+
+/**
+ *  \brief Record layout compiled into shuffle masks.
+ *
+ *  Records of at most 16 bytes use a single mask covering as many
+ *  whole records as fit in a lane, with the same kernels as narrow
+ *  elements. Wider records use a window per 16-byte run of bytes
+ *  that only move within the run. For the scalar tail, `fields` holds
+ *  the fields to reverse, or `order` the source byte of each byte
+ *  for an arbitrary permutation. Both are empty for the identity.
+ */
+struct bswap_layout
+{
+    shuffle_mask mask;
+    std::vector<record_window> windows;
+    std::vector<bswap_field> fields;
+    std::vector<uint8_t> order;
+    size_t record_size;
+    void* allocation;
+};
+
+
+/**
+ *  \brief Check every byte in `[start, end)` comes from the same range.
+ */
+static bool
+is_closed_window(
+    const std::vector<size_t>& permutation,
+    size_t start,
+    size_t end
+)
+noexcept
+{
+    for (size_t k = start; k < end; ++k) {
+        if (permutation[k] < start || permutation[k] >= end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ *  \brief Tile a record wider than 16 bytes with windows.
+ *
+ *  Each window ends at the last boundary within 16 bytes of its start
+ *  that no byte crosses, which for byteswapped fields is the last
+ *  field boundary. A byte moving 16 bytes or more cannot be tiled, and
+ *  leaves no windows, so every record is converted by the scalar path.
+ */
+static void
+make_record_windows(
+    std::vector<record_window>& windows,
+    const std::vector<size_t>& permutation
+)
+{
+    size_t record_size = permutation.size();
+    size_t start = 0;
+    while (start < record_size) {
+        size_t end = std::min(start + 16, record_size);
+        while (end > start && !is_closed_window(permutation, start, end)) {
+            --end;
+        }
+        if (end == start) {
+            windows.clear();
+            return;
+        }
+
+        record_window window;
+        window.offset = start;
+        for (size_t j = 0; j < 16; ++j) {
+            size_t k = start + j;
+            window.lane[j] = static_cast<uint8_t>(k < end ? permutation[k] - start : j);
+        }
+        windows.push_back(window);
+        start = end;
+    }
+}
+
+
+/**
+ *  \brief Reverse each field of every record, after copying them,
+ *  or permute the bytes of every record through a copy.
+ */
+static void
+bswap_records_scalar(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t records,
+    const bswap_layout& layout
+)
+noexcept
+{
+    size_t record_size = layout.record_size;
+    if (!layout.order.empty()) {
+        // Permutations take an 8-bit map, so records fit in 256 bytes.
+        const uint8_t* order = layout.order.data();
+        uint8_t record[256];
+        for (size_t i = 0; i < records; ++i) {
+            std::memcpy(record, src + i * record_size, record_size);
+            uint8_t* d = dst + i * record_size;
+            for (size_t j = 0; j < record_size; ++j) {
+                d[j] = record[order[j]];
+            }
+        }
+        return;
+    }
+
+    if (dst != src) {
+        std::memcpy(dst, src, records * record_size);
+    }
+    for (size_t i = 0; i < records; ++i) {
+        uint8_t* d = dst + i * record_size;
+        for (const bswap_field& field: layout.fields) {
+            bswap_impl(d + field.offset, field.width);
+        }
+    }
+}
+
+
+/**
+ *  \brief Allocate an empty layout.
+ *
+ *  The shuffle mask requires the alignment of a 512-bit register,
+ *  which `new` does not guarantee before C++17.
+ */
+static bswap_layout*
+allocate_layout()
+{
+    size_t alignment = alignof(bswap_layout);
+    void* allocation = ::operator new(sizeof(bswap_layout) + alignment);
+    uintptr_t address = reinterpret_cast<uintptr_t>(allocation);
+    address = (address + alignment - 1) / alignment * alignment;
+    bswap_layout* layout = new (reinterpret_cast<void*>(address)) bswap_layout();
+    layout->allocation = allocation;
+    return layout;
+}
+
+
+/**
+ *  \brief Compile the source byte of each byte in a record into the
+ *  shuffle mask, or the windows of a wider record.
+ */
+static void
+compile_layout(
+    bswap_layout& layout,
+    const std::vector<size_t>& permutation
+)
+{
+    size_t record_size = permutation.size();
+    layout.record_size = record_size;
+    if (record_size <= 16) {
+        uint8_t bytes[16];
+        for (size_t j = 0; j < record_size; ++j) {
+            bytes[j] = static_cast<uint8_t>(permutation[j]);
+        }
+        make_record_mask(layout.mask, bytes, record_size);
+    } else {
+        make_record_windows(layout.windows, permutation);
+    }
+}
+
+
+/**
+ *  \brief Compile an arbitrary permutation of a `width`-byte record.
+ */
+static void
+compile_permutation(
+    bswap_layout& layout,
+    const uint8_t* order,
+    size_t width
+)
+{
+    std::vector<size_t> permutation(order, order + width);
+    bool identity = true;
+    for (size_t j = 0; j < width; ++j) {
+        identity = identity && order[j] == j;
+    }
+    if (!identity) {
+        layout.order.assign(order, order + width);
+    }
+    compile_layout(layout, permutation);
+}
+
+
+/**
+ *  \brief Convert records with the vector kernels, and the remaining
+ *  records with scalar swaps.
+ */
+static void
+memcpy_bswap_layout(
+    void* dst,
+    const void* src,
+    size_t records,
+    const bswap_layout& layout
+)
+noexcept
+{
+    const bswap_dispatch& table = dispatch();
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    size_t record_size = layout.record_size;
+    size_t bytes = records * record_size;
+    size_t done = 0;
+
+    if (layout.fields.empty() && layout.order.empty()) {
+        if (d != s) {
+            std::memcpy(d, s, bytes);
+        }
+        return;
+    } else if (record_size <= 16) {
+        done = table.shuffle(d, s, bytes, layout.mask) / record_size;
+    } else if (!layout.windows.empty()) {
+        // The last window of a record may read into the next record.
+        size_t reach = layout.windows.back().offset + 16;
+        if (bytes >= reach) {
+            size_t count = std::min((bytes - reach) / record_size + 1, records);
+            done = table.record(d, s, count, record_size, layout.windows.data(), layout.windows.size());
+        }
+    }
+
+    size_t offset = done * record_size;
+    bswap_records_scalar(d + offset, s + offset, records - done, layout);
+}
+
+
+/**
+ *  \brief Layout converting between PDP-endian and host 32-bit words.
+ *
+ *  PDP-11 words store the high 16-bit half first, each half in
+ *  little-endian order, so `0x0A0B0C0D` is stored as `0B 0A 0D 0C`.
+ *  Either host order differs from this by exchanging bytes or halves,
+ *  which is its own inverse.
+ */
+static const bswap_layout&
+pdp32_layout()
+noexcept
+{
+    struct table
+    {
+        bswap_layout layout;
+
+        table()
+        {
+            const uint8_t little[4] = {2, 3, 0, 1};
+            const uint8_t big[4] = {1, 0, 3, 2};
+            compile_permutation(layout, BYTE_ORDER == LITTLE_ENDIAN ? little : big, 4);
+        }
+    };
+    static const table pdp;
+    return pdp.layout;
+}
+
+
+/**
+ *  \brief Layout converting between FPA and host 64-bit doubles.
+ *
+ *  The ARM FPA stores the high 32-bit word of a double first, each
+ *  word in little-endian order. Either host order differs from this
+ *  by exchanging words or the bytes within words, which is its own
+ *  inverse.
+ */
+static const bswap_layout&
+fpa64_layout()
+noexcept
+{
+    struct table
+    {
+        bswap_layout layout;
+
+        table()
+        {
+            const uint8_t little[8] = {4, 5, 6, 7, 0, 1, 2, 3};
+            const uint8_t big[8] = {3, 2, 1, 0, 7, 6, 5, 4};
+            compile_permutation(layout, BYTE_ORDER == LITTLE_ENDIAN ? little : big, 8);
+        }
+    };
+    static const table fpa;
+    return fpa.layout;
+}
+
+// FLOATS
+// ------
+
+/**
+ *  \brief Convert 32-bit floats between host and `order` byte order.
+ *
+ *  Single-precision floats share the integer byte order.
+ */
+static void
+memcpy_convert_f32(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int order
+)
+noexcept
+{
+    if (order == BYTE_ORDER) {
+        if (dst != src) {
+            std::memcpy(dst, src, bytes);
+        }
+    } else {
+        memcpy_bswap_vector<4>(dst, src, bytes, dispatch().swap32, dispatch().alignment);
+    }
+}
+
+
+/**
+ *  \brief Shuffle mask exchanging the 32-bit words of each double.
+ */
+static const shuffle_mask&
+word_swap_mask()
+noexcept
+{
+    struct table
+    {
+        shuffle_mask mask;
+
+        table() noexcept
+        {
+            const uint8_t permutation[8] = {4, 5, 6, 7, 0, 1, 2, 3};
+            make_record_mask(mask, permutation, 8);
+        }
+    };
+    static const table words;
+    return words.mask;
+}
+
+
+/**
+ *  \brief Convert 64-bit doubles between host and `order` byte order.
+ *
+ *  Doubles store their bytes within each 32-bit word in `BYTE_ORDER`,
+ *  and the two words in `FLOAT_WORD_ORDER`. When these differ, either
+ *  the bytes within each word or the words themselves are out of order,
+ *  never both, and each case is a single vector shuffle.
+ */
+static void
+memcpy_convert_f64(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int order
+)
+noexcept
+{
+    const bswap_dispatch& table = dispatch();
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+
+    if (FLOAT_WORD_ORDER == BYTE_ORDER) {
+        if (order == BYTE_ORDER) {
+            if (d != s) {
+                std::memcpy(d, s, bytes);
+            }
+        } else {
+            memcpy_bswap_vector<8>(d, s, bytes, table.swap64, table.alignment);
+        }
+    } else if (order == FLOAT_WORD_ORDER) {
+        memcpy_bswap_vector<4>(d, s, bytes, table.swap32, table.alignment);
+    } else {
+        size_t done = table.shuffle(d, s, bytes, word_swap_mask());
+        for (size_t i = done; i < bytes; i += 8) {
+            uint8_t word[4];
+            std::memcpy(word, s + i, 4);
+            std::memmove(d + i, s + i + 4, 4);
+            std::memcpy(d + i + 4, word, 4);
+        }
+    }
+}
+
+/**
+ *  \brief Byteswap and checksum the source in cache-sized blocks.
+ *
+ *  Each block is checksummed before it is byteswapped, so the source
+ *  is only read once from memory, and the checksum is of the original
+ *  bytes even when `dst` equals `src`.
+ */
+static uint32_t
+memcpy_bswap_crc32c_width(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    size_t width,
+    uint32_t crc
+)
+noexcept
+{
+    const bswap_dispatch& table = dispatch();
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    size_t block = std::max(CRC32C_BLOCK_SIZE / width, size_t(1)) * width;
+
+    crc = ~crc;
+    for (size_t i = 0; i < bytes; i += block) {
+        size_t n = std::min(block, bytes - i);
+        crc = table.crc32c(crc, s + i, n);
+        memcpy_bswap_width(d + i, s + i, n, width);
+    }
+
+    return ~crc;
+}
+
+// WIDENING
+// --------
+
+/**
+ *  \brief Vector kernel converting 16-bit samples to 32-bit values.
+ *
+ *  Returns the number of samples converted, and the caller converts
+ *  the remaining tail.
+ */
+typedef size_t (*widen_kernel)(void*, const uint8_t*, size_t);
+
+
+static size_t
+widen_none(
+    void*,
+    const uint8_t*,
+    size_t
+)
+noexcept
+{
+    return 0;
+}
+
+
+/**
+ *  \brief Convert an IEEE half-precision value to single-precision bits.
+ */
+static uint32_t
+half_to_float_bits(
+    uint16_t half
+)
+noexcept
+{
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+
+    if (exponent == 0x1f) {
+        return sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        return sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        return sign;
+    }
+
+    // Subnormal halves are normal floats.
+    exponent = 113;
+    while ((mantissa & 0x400) == 0) {
+        mantissa <<= 1;
+        --exponent;
+    }
+    return sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+}
+
+
+#if defined(PYCPP_BYTEORDER_X86)
+
+// PSHUFB masks moving 4 16-bit samples to the high half of each 32-bit
+// lane, with and without a byteswap, for the low and high 8 bytes.
+alignas(16) static const uint8_t WIDEN16_MASK[2][2][16] = {
+    {
+        {0x80, 0x80, 0, 1, 0x80, 0x80, 2, 3, 0x80, 0x80, 4, 5, 0x80, 0x80, 6, 7},
+        {0x80, 0x80, 8, 9, 0x80, 0x80, 10, 11, 0x80, 0x80, 12, 13, 0x80, 0x80, 14, 15}
+    },
+    {
+        {0x80, 0x80, 1, 0, 0x80, 0x80, 3, 2, 0x80, 0x80, 5, 4, 0x80, 0x80, 7, 6},
+        {0x80, 0x80, 9, 8, 0x80, 0x80, 11, 10, 0x80, 0x80, 13, 12, 0x80, 0x80, 15, 14}
+    }
+};
+
+
+/**
+ *  \brief Widen 8 samples to the high halves of two 32-bit vectors.
+ */
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static inline void
+widen_high_ssse3(
+    const uint8_t* src,
+    __m128i& lo,
+    __m128i& hi
+)
+noexcept
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    lo = _mm_shuffle_epi8(v, _mm_load_si128(reinterpret_cast<const __m128i*>(WIDEN16_MASK[Swap][0])));
+    hi = _mm_shuffle_epi8(v, _mm_load_si128(reinterpret_cast<const __m128i*>(WIDEN16_MASK[Swap][1])));
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+widen_i32_ssse3(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i lo, hi;
+        widen_high_ssse3<Swap>(src + 2 * i, lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 4 * i), _mm_srai_epi32(lo, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 4 * i + 16), _mm_srai_epi32(hi, 16));
+    }
+
+    return i;
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+widen_f32_ssse3(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<float*>(dst);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i lo, hi;
+        widen_high_ssse3<Swap>(src + 2 * i, lo, hi);
+        _mm_storeu_ps(d + i, _mm_cvtepi32_ps(_mm_srai_epi32(lo, 16)));
+        _mm_storeu_ps(d + i + 4, _mm_cvtepi32_ps(_mm_srai_epi32(hi, 16)));
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Widen bfloat16 values, which are the high halves of floats.
+ */
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+widen_bf16_ssse3(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i lo, hi;
+        widen_high_ssse3<Swap>(src + 2 * i, lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 4 * i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 4 * i + 16), hi);
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Load 8 samples in host byte order.
+ */
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static inline __m128i
+load_samples_ssse3(
+    const uint8_t* src
+)
+noexcept
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    if (Swap) {
+        v = _mm_shuffle_epi8(v, _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP16_MASK)));
+    }
+    return v;
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+widen_i32_avx2(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<__m256i*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v0 = load_samples_ssse3<Swap>(src + 2 * i);
+        __m128i v1 = load_samples_ssse3<Swap>(src + 2 * i + 16);
+        _mm256_storeu_si256(d + i / 8, _mm256_cvtepi16_epi32(v0));
+        _mm256_storeu_si256(d + i / 8 + 1, _mm256_cvtepi16_epi32(v1));
+    }
+
+    return i;
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+widen_f32_avx2(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<float*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v0 = load_samples_ssse3<Swap>(src + 2 * i);
+        __m128i v1 = load_samples_ssse3<Swap>(src + 2 * i + 16);
+        _mm256_storeu_ps(d + i, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v0)));
+        _mm256_storeu_ps(d + i + 8, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v1)));
+    }
+
+    return i;
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+widen_bf16_avx2(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    // Each lane of the mask widens the low or high 8 bytes of the
+    // broadcast samples.
+    auto* d = reinterpret_cast<__m256i*>(dst);
+    __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(WIDEN16_MASK[Swap][0]));
+    __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(WIDEN16_MASK[Swap][1]));
+    __m256i mask = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i + 16));
+        _mm256_storeu_si256(d + i / 8, _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(v0), mask));
+        _mm256_storeu_si256(d + i / 8 + 1, _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(v1), mask));
+    }
+
+    return i;
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("avx,f16c")
+static size_t
+widen_f16_f16c(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<float*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v0 = load_samples_ssse3<Swap>(src + 2 * i);
+        __m128i v1 = load_samples_ssse3<Swap>(src + 2 * i + 16);
+        _mm256_storeu_ps(d + i, _mm256_cvtph_ps(v0));
+        _mm256_storeu_ps(d + i + 8, _mm256_cvtph_ps(v1));
+    }
+
+    return i;
+}
+
+#endif                  // PYCPP_BYTEORDER_X86
+
+
+#if defined(PYCPP_BYTEORDER_NEON)
+
+/**
+ *  \brief Load 8 samples in host byte order.
+ */
+template <bool Swap>
+static inline uint16x8_t
+load_samples_neon(
+    const uint8_t* src
+)
+noexcept
+{
+    uint8x16_t v = vld1q_u8(src);
+    if (Swap) {
+        v = vrev16q_u8(v);
+    }
+    return vreinterpretq_u16_u8(v);
+}
+
+
+template <bool Swap>
+static size_t
+widen_i32_neon(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<int32_t*>(dst);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t v = vreinterpretq_s16_u16(load_samples_neon<Swap>(src + 2 * i));
+        vst1q_s32(d + i, vmovl_s16(vget_low_s16(v)));
+        vst1q_s32(d + i + 4, vmovl_s16(vget_high_s16(v)));
+    }
+
+    return i;
+}
+
+
+template <bool Swap>
+static size_t
+widen_f32_neon(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<float*>(dst);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t v = vreinterpretq_s16_u16(load_samples_neon<Swap>(src + 2 * i));
+        vst1q_f32(d + i, vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))));
+        vst1q_f32(d + i + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))));
+    }
+
+    return i;
+}
+
+
+template <bool Swap>
+static size_t
+widen_bf16_neon(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<uint32_t*>(dst);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = load_samples_neon<Swap>(src + 2 * i);
+        vst1q_u32(d + i, vshll_n_u16(vget_low_u16(v), 16));
+        vst1q_u32(d + i + 4, vshll_n_u16(vget_high_u16(v), 16));
+    }
+
+    return i;
+}
+
+
+#if defined(PYCPP_ARM64)
+
+template <bool Swap>
+static size_t
+widen_f16_neon(
+    void* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<float*>(dst);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = load_samples_neon<Swap>(src + 2 * i);
+        vst1q_f32(d + i, vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(v))));
+        vst1q_f32(d + i + 4, vcvt_f32_f16(vreinterpret_f16_u16(vget_high_u16(v))));
+    }
+
+    return i;
+}
+
+#endif                  // PYCPP_ARM64
+
+#endif                  // PYCPP_BYTEORDER_NEON
+
+
+/**
+ *  \brief Widening kernels for the host CPU, indexed by whether the
+ *  samples are byteswapped.
+ */
+struct widen_dispatch
+{
+    widen_kernel i32[2];
+    widen_kernel f32[2];
+    widen_kernel f16[2];
+    widen_kernel bf16[2];
+};
+
+
+static widen_dispatch
+make_widen_dispatch()
+noexcept
+{
+    widen_dispatch table = {
+        {widen_none, widen_none},
+        {widen_none, widen_none},
+        {widen_none, widen_none},
+        {widen_none, widen_none}
+    };
+
+#if defined(PYCPP_BYTEORDER_X86)
+    cpu_features features = detect_cpu_features();
+    if (features.avx2) {
+        table.i32[0] = widen_i32_avx2<false>;
+        table.i32[1] = widen_i32_avx2<true>;
+        table.f32[0] = widen_f32_avx2<false>;
+        table.f32[1] = widen_f32_avx2<true>;
+        table.bf16[0] = widen_bf16_avx2<false>;
+        table.bf16[1] = widen_bf16_avx2<true>;
+    } else if (features.ssse3) {
+        table.i32[0] = widen_i32_ssse3<false>;
+        table.i32[1] = widen_i32_ssse3<true>;
+        table.f32[0] = widen_f32_ssse3<false>;
+        table.f32[1] = widen_f32_ssse3<true>;
+        table.bf16[0] = widen_bf16_ssse3<false>;
+        table.bf16[1] = widen_bf16_ssse3<true>;
+    }
+    if (features.f16c) {
+        table.f16[0] = widen_f16_f16c<false>;
+        table.f16[1] = widen_f16_f16c<true>;
+    }
+#elif defined(PYCPP_BYTEORDER_NEON)
+    table.i32[0] = widen_i32_neon<false>;
+    table.i32[1] = widen_i32_neon<true>;
+    table.f32[0] = widen_f32_neon<false>;
+    table.f32[1] = widen_f32_neon<true>;
+    table.bf16[0] = widen_bf16_neon<false>;
+    table.bf16[1] = widen_bf16_neon<true>;
+#   if defined(PYCPP_ARM64)
+    table.f16[0] = widen_f16_neon<false>;
+    table.f16[1] = widen_f16_neon<true>;
+#   endif
+#endif
+
+    return table;
+}
+
+
+static const widen_dispatch&
+widen_kernels()
+noexcept
+{
+    static const widen_dispatch table = make_widen_dispatch();
+    return table;
+}
+
+
+/**
+ *  \brief Convert `n` 16-bit samples in `order` byte order, with the
+ *  vector kernel for the body and `scalar` for the tail.
+ */
+template <typename T, typename F>
+static void
+widen_samples(
+    T* dst,
+    const void* src,
+    size_t n,
+    int order,
+    const widen_kernel* kernels,
+    F scalar
+)
+noexcept
+{
+    bool swap = order != BYTE_ORDER;
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    size_t done = kernels[swap](dst, s, n);
+    for (size_t i = done; i < n; ++i) {
+        uint16_t v;
+        std::memcpy(&v, s + 2 * i, 2);
+        dst[i] = scalar(swap ? pycpp::byteswap(v) : v);
+    }
+}
+
+
+template <int Order>
+static void
+widen_i32(
+    int32_t* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    widen_samples(dst, src, n, Order, widen_kernels().i32, [](uint16_t v) {
+        return static_cast<int32_t>(static_cast<int16_t>(v));
+    });
+}
+
+
+template <int Order>
+static void
+widen_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    widen_samples(dst, src, n, Order, widen_kernels().f32, [](uint16_t v) {
+        return static_cast<float>(static_cast<int16_t>(v));
+    });
+}
+
+
+template <int Order>
+static void
+widen_f16(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    widen_samples(dst, src, n, Order, widen_kernels().f16, [](uint16_t v) {
+        return pycpp::byteorder_detail::bit_cast<float>(half_to_float_bits(v));
+    });
+}
+
+
+template <int Order>
+static void
+widen_bf16(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    widen_samples(dst, src, n, Order, widen_kernels().bf16, [](uint16_t v) {
+        return pycpp::byteorder_detail::bit_cast<float>(static_cast<uint32_t>(v) << 16);
+    });
+}
+
+// UTF-16
+// ------
+
+// Code units validated by the scalar path each time a vector kernel
+// stops at a surrogate or non-ASCII unit, before trying it again.
+static const size_t UTF16_SCALAR_RUN = 16;
+
+/**
+ *  \brief Vector kernel converting a prefix of `n` UTF-16 code units.
+ *
+ *  Kernels stop before the first vector that needs the scalar path,
+ *  which is one holding an unpaired surrogate when converting byte
+ *  order, or a unit above 0x7F when converting to UTF-8, and return
+ *  the number of units converted. Each unit converted to UTF-8 writes
+ *  a single byte.
+ *
+ *  Surrogates are paired by comparing the high surrogates of each
+ *  vector with the low surrogates of the same vector loaded one unit
+ *  later, so only the first unit must be checked for a leading low
+ *  surrogate. A prefix ending in a high surrogate is extended by its
+ *  low surrogate, so the scalar path never starts within a pair.
+ */
+typedef size_t (*utf16_kernel)(uint8_t*, const uint8_t*, size_t);
+
+
+static size_t
+utf16_none(
+    uint8_t*,
+    const uint8_t*,
+    size_t
+)
+noexcept
+{
+    return 0;
+}
+
+
+static inline bool
+is_surrogate(
+    uint16_t unit
+)
+noexcept
+{
+    return (unit & 0xF800) == 0xD800;
+}
+
+
+static inline bool
+is_high_surrogate(
+    uint16_t unit
+)
+noexcept
+{
+    return (unit & 0xFC00) == 0xD800;
+}
+
+
+static inline bool
+is_low_surrogate(
+    uint16_t unit
+)
+noexcept
+{
+    return (unit & 0xFC00) == 0xDC00;
+}
+
+
+/**
+ *  \brief Load the code unit at `index` in host byte order.
+ */
+static inline uint16_t
+load_unit(
+    const uint8_t* src,
+    size_t index,
+    bool swap
+)
+noexcept
+{
+    uint16_t unit;
+    std::memcpy(&unit, src + 2 * index, 2);
+    return swap ? pycpp::byteswap(unit) : unit;
+}
+
+
+/**
+ *  \brief Extend a converted prefix of `i` units ending in a high
+ *  surrogate by the low surrogate the vector checks paired it with.
+ */
+template <bool Swap>
+static inline size_t
+finish_pair(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t i
+)
+noexcept
+{
+    if (i > 0 && is_high_surrogate(load_unit(dst, i - 1, false))) {
+        uint16_t unit = load_unit(src, i, Swap);
+        std::memcpy(dst + 2 * i, &unit, 2);
+        return i + 1;
+    }
+    return i;
+}
+
+
+#if defined(PYCPP_BYTEORDER_X86)
+
+/**
+ *  \brief Load 8 code units in host byte order.
+ */
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static inline __m128i
+load_units_ssse3(
+    const uint8_t* src
+)
+noexcept
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    if (Swap) {
+        v = _mm_shuffle_epi8(v, _mm_load_si128(reinterpret_cast<const __m128i*>(BSWAP16_MASK)));
+    }
+    return v;
+}
+
+
+/**
+ *  \brief Find unpaired surrogates in `v`, given the units one later.
+ */
+PYCPP_BYTEORDER_TARGET("ssse3")
+static inline __m128i
+unpaired_ssse3(
+    __m128i v,
+    __m128i next
+)
+noexcept
+{
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFC00));
+    __m128i high = _mm_cmpeq_epi16(_mm_and_si128(v, mask), _mm_set1_epi16(static_cast<short>(0xD800)));
+    __m128i low = _mm_cmpeq_epi16(_mm_and_si128(next, mask), _mm_set1_epi16(static_cast<short>(0xDC00)));
+    return _mm_xor_si128(high, low);
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+utf16_copy_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    if (n == 0 || is_low_surrogate(load_unit(src, 0, Swap))) {
+        return 0;
+    }
+
+    size_t i = 0;
+    for (; i + 33 <= n; i += 32) {
+        __m128i v0 = load_units_ssse3<Swap>(src + 2 * i);
+        __m128i v1 = load_units_ssse3<Swap>(src + 2 * i + 16);
+        __m128i v2 = load_units_ssse3<Swap>(src + 2 * i + 32);
+        __m128i v3 = load_units_ssse3<Swap>(src + 2 * i + 48);
+        __m128i n0 = load_units_ssse3<Swap>(src + 2 * i + 2);
+        __m128i n1 = load_units_ssse3<Swap>(src + 2 * i + 18);
+        __m128i n2 = load_units_ssse3<Swap>(src + 2 * i + 34);
+        __m128i n3 = load_units_ssse3<Swap>(src + 2 * i + 50);
+        __m128i any = _mm_or_si128(
+            _mm_or_si128(unpaired_ssse3(v0, n0), unpaired_ssse3(v1, n1)),
+            _mm_or_si128(unpaired_ssse3(v2, n2), unpaired_ssse3(v3, n3))
+        );
+        if (_mm_movemask_epi8(any)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), v0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16), v1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 32), v2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 48), v3);
+    }
+    for (; i + 9 <= n; i += 8) {
+        __m128i v = load_units_ssse3<Swap>(src + 2 * i);
+        __m128i next = load_units_ssse3<Swap>(src + 2 * i + 2);
+        if (_mm_movemask_epi8(unpaired_ssse3(v, next))) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), v);
+    }
+
+    return finish_pair<Swap>(dst, src, i);
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+utf16_ascii_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v0 = load_units_ssse3<Swap>(src + 2 * i);
+        __m128i v1 = load_units_ssse3<Swap>(src + 2 * i + 16);
+        __m128i masked = _mm_and_si128(_mm_or_si128(v0, v1), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(masked, _mm_setzero_si128())) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(v0, v1));
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Load 16 code units in host byte order.
+ */
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("avx2")
+static inline __m256i
+load_units_avx2(
+    const uint8_t* src
+)
+noexcept
+{
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    if (Swap) {
+        v = _mm256_shuffle_epi8(v, _mm256_load_si256(reinterpret_cast<const __m256i*>(BSWAP16_MASK)));
+    }
+    return v;
+}
+
+
+/**
+ *  \brief Find unpaired surrogates in `v`, given the units one later.
+ */
+PYCPP_BYTEORDER_TARGET("avx2")
+static inline __m256i
+unpaired_avx2(
+    __m256i v,
+    __m256i next
+)
+noexcept
+{
+    const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xFC00));
+    __m256i high = _mm256_cmpeq_epi16(_mm256_and_si256(v, mask), _mm256_set1_epi16(static_cast<short>(0xD800)));
+    __m256i low = _mm256_cmpeq_epi16(_mm256_and_si256(next, mask), _mm256_set1_epi16(static_cast<short>(0xDC00)));
+    return _mm256_xor_si256(high, low);
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+utf16_copy_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    if (n == 0 || is_low_surrogate(load_unit(src, 0, Swap))) {
+        return 0;
+    }
+
+    size_t i = 0;
+    for (; i + 65 <= n; i += 64) {
+        __m256i v0 = load_units_avx2<Swap>(src + 2 * i);
+        __m256i v1 = load_units_avx2<Swap>(src + 2 * i + 32);
+        __m256i v2 = load_units_avx2<Swap>(src + 2 * i + 64);
+        __m256i v3 = load_units_avx2<Swap>(src + 2 * i + 96);
+        __m256i n0 = load_units_avx2<Swap>(src + 2 * i + 2);
+        __m256i n1 = load_units_avx2<Swap>(src + 2 * i + 34);
+        __m256i n2 = load_units_avx2<Swap>(src + 2 * i + 66);
+        __m256i n3 = load_units_avx2<Swap>(src + 2 * i + 98);
+        __m256i any = _mm256_or_si256(
+            _mm256_or_si256(unpaired_avx2(v0, n0), unpaired_avx2(v1, n1)),
+            _mm256_or_si256(unpaired_avx2(v2, n2), unpaired_avx2(v3, n3))
+        );
+        if (!_mm256_testz_si256(any, any)) {
+            break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), v0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i + 32), v1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i + 64), v2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i + 96), v3);
+    }
+
+    for (; i + 9 <= n; i += 8) {
+        __m128i v = load_units_ssse3<Swap>(src + 2 * i);
+        __m128i next = load_units_ssse3<Swap>(src + 2 * i + 2);
+        if (_mm_movemask_epi8(unpaired_ssse3(v, next))) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), v);
+    }
+
+    return finish_pair<Swap>(dst, src, i);
+}
+
+
+template <bool Swap>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+utf16_ascii_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    const __m256i high = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v0 = load_units_avx2<Swap>(src + 2 * i);
+        __m256i v1 = load_units_avx2<Swap>(src + 2 * i + 32);
+        if (!_mm256_testz_si256(_mm256_or_si256(v0, v1), high)) {
+            break;
+        }
+        // PACKUSWB packs within each 128-bit lane.
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v0, v1), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+    for (; i + 16 <= n; i += 16) {
+        __m128i v0 = load_units_ssse3<Swap>(src + 2 * i);
+        __m128i v1 = load_units_ssse3<Swap>(src + 2 * i + 16);
+        if (!_mm_testz_si128(_mm_or_si128(v0, v1), _mm256_castsi256_si128(high))) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(v0, v1));
+    }
+
+    return i;
+}
+
+#endif                  // PYCPP_BYTEORDER_X86
+
+
+#if defined(PYCPP_BYTEORDER_NEON)
+
+/**
+ *  \brief Check if any bit of a vector is set.
+ */
+static inline bool
+any_neon(
+    uint16x8_t v
+)
+noexcept
+{
+    uint64x2_t lanes = vreinterpretq_u64_u16(v);
+    return (vgetq_lane_u64(lanes, 0) | vgetq_lane_u64(lanes, 1)) != 0;
+}
+
+
+/**
+ *  \brief Find unpaired surrogates in `v`, given the units one later.
+ */
+static inline uint16x8_t
+unpaired_neon(
+    uint16x8_t v,
+    uint16x8_t next
+)
+noexcept
+{
+    const uint16x8_t mask = vdupq_n_u16(0xFC00);
+    uint16x8_t high = vceqq_u16(vandq_u16(v, mask), vdupq_n_u16(0xD800));
+    uint16x8_t low = vceqq_u16(vandq_u16(next, mask), vdupq_n_u16(0xDC00));
+    return veorq_u16(high, low);
+}
+
+
+template <bool Swap>
+static size_t
+utf16_copy_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    if (n == 0 || is_low_surrogate(load_unit(src, 0, Swap))) {
+        return 0;
+    }
+
+    size_t i = 0;
+    for (; i + 33 <= n; i += 32) {
+        uint16x8_t v0 = load_samples_neon<Swap>(src + 2 * i);
+        uint16x8_t v1 = load_samples_neon<Swap>(src + 2 * i + 16);
+        uint16x8_t v2 = load_samples_neon<Swap>(src + 2 * i + 32);
+        uint16x8_t v3 = load_samples_neon<Swap>(src + 2 * i + 48);
+        uint16x8_t n0 = load_samples_neon<Swap>(src + 2 * i + 2);
+        uint16x8_t n1 = load_samples_neon<Swap>(src + 2 * i + 18);
+        uint16x8_t n2 = load_samples_neon<Swap>(src + 2 * i + 34);
+        uint16x8_t n3 = load_samples_neon<Swap>(src + 2 * i + 50);
+        uint16x8_t any = vorrq_u16(
+            vorrq_u16(unpaired_neon(v0, n0), unpaired_neon(v1, n1)),
+            vorrq_u16(unpaired_neon(v2, n2), unpaired_neon(v3, n3))
+        );
+        if (any_neon(any)) {
+            break;
+        }
+        vst1q_u8(dst + 2 * i, vreinterpretq_u8_u16(v0));
+        vst1q_u8(dst + 2 * i + 16, vreinterpretq_u8_u16(v1));
+        vst1q_u8(dst + 2 * i + 32, vreinterpretq_u8_u16(v2));
+        vst1q_u8(dst + 2 * i + 48, vreinterpretq_u8_u16(v3));
+    }
+    for (; i + 9 <= n; i += 8) {
+        uint16x8_t v = load_samples_neon<Swap>(src + 2 * i);
+        uint16x8_t next = load_samples_neon<Swap>(src + 2 * i + 2);
+        if (any_neon(unpaired_neon(v, next))) {
+            break;
+        }
+        vst1q_u8(dst + 2 * i, vreinterpretq_u8_u16(v));
+    }
+
+    return finish_pair<Swap>(dst, src, i);
+}
+
+
+template <bool Swap>
+static size_t
+utf16_ascii_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    const uint16x8_t high = vdupq_n_u16(0xFF80);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint16x8_t v0 = load_samples_neon<Swap>(src + 2 * i);
+        uint16x8_t v1 = load_samples_neon<Swap>(src + 2 * i + 16);
+        if (any_neon(vandq_u16(vorrq_u16(v0, v1), high))) {
+            break;
+        }
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(v0), vmovn_u16(v1)));
+    }
+
+    return i;
+}
+
+#endif                  // PYCPP_BYTEORDER_NEON
+
+
+/**
+ *  \brief UTF-16 kernels for the host CPU, indexed by whether the
+ *  code units are byteswapped.
+ */
+struct utf16_dispatch
+{
+    utf16_kernel copy[2];
+    utf16_kernel ascii[2];
+};
+
+
+static utf16_dispatch
+make_utf16_dispatch()
+noexcept
+{
+    utf16_dispatch table = {
+        {utf16_none, utf16_none},
+        {utf16_none, utf16_none}
+    };
+
+#if defined(PYCPP_BYTEORDER_X86)
+    cpu_features features = detect_cpu_features();
+    if (features.avx2) {
+        table.copy[0] = utf16_copy_avx2<false>;
+        table.copy[1] = utf16_copy_avx2<true>;
+        table.ascii[0] = utf16_ascii_avx2<false>;
+        table.ascii[1] = utf16_ascii_avx2<true>;
+    } else if (features.ssse3) {
+        table.copy[0] = utf16_copy_ssse3<false>;
+        table.copy[1] = utf16_copy_ssse3<true>;
+        table.ascii[0] = utf16_ascii_ssse3<false>;
+        table.ascii[1] = utf16_ascii_ssse3<true>;
+    }
+#elif defined(PYCPP_BYTEORDER_NEON)
+    table.copy[0] = utf16_copy_neon<false>;
+    table.copy[1] = utf16_copy_neon<true>;
+    table.ascii[0] = utf16_ascii_neon<false>;
+    table.ascii[1] = utf16_ascii_neon<true>;
+#endif
+
+    return table;
+}
+
+
+static const utf16_dispatch&
+utf16_kernels()
+noexcept
+{
+    static const utf16_dispatch table = make_utf16_dispatch();
+    return table;
+}
+
+
+/**
+ *  \brief Convert `n` UTF-16 code units from `order` to host byte
+ *  order, returning the index of the first invalid unit, or `n`.
+ *
+ *  Vectors without surrogates are converted by the kernels, and the
+ *  scalar path pairs the surrogates. Once an invalid unit is found,
+ *  the rest of the buffer only needs its byte order converted.
+ */
+static size_t
+memcpy_utf16(
+    void* dst,
+    const void* src,
+    size_t n,
+    int order
+)
+noexcept
+{
+    const utf16_dispatch& table = utf16_kernels();
+    bool swap = order != BYTE_ORDER;
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+
+    size_t i = 0;
+    while (i < n) {
+        i += table.copy[swap](d + 2 * i, s + 2 * i, n - i);
+        size_t end = std::min(i + UTF16_SCALAR_RUN, n);
+        while (i < end) {
+            uint16_t unit = load_unit(s, i, swap);
+            if (!is_surrogate(unit)) {
+                std::memcpy(d + 2 * i, &unit, 2);
+                i += 1;
+                continue;
+            }
+
+            uint16_t next = i + 1 < n ? load_unit(s, i + 1, swap) : 0;
+            if (!is_high_surrogate(unit) || !is_low_surrogate(next)) {
+                if (swap) {
+                    memcpy_bswap_width(d + 2 * i, s + 2 * i, 2 * (n - i), 2);
+                } else if (d != s) {
+                    std::memcpy(d + 2 * i, s + 2 * i, 2 * (n - i));
+                }
+                return i;
+            }
+            std::memcpy(d + 2 * i, &unit, 2);
+            std::memcpy(d + 2 * i + 2, &next, 2);
+            i += 2;
+        }
+    }
+
+    return n;
+}
+
+
+/**
+ *  \brief Convert `n` UTF-16 code units in `order` byte order to UTF-8,
+ *  returning the index of the first invalid unit, or `n`.
+ *
+ *  Runs of ASCII are narrowed by the kernels, and other units are
+ *  encoded by the scalar path, which stops at the first invalid unit.
+ */
+static size_t
+convert_utf16_to_utf8(
+    char* dst,
+    const void* src,
+    size_t n,
+    size_t* written,
+    int order
+)
+noexcept
+{
+    const utf16_dispatch& table = utf16_kernels();
+    bool swap = order != BYTE_ORDER;
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < n) {
+        size_t done = table.ascii[swap](d + j, s + 2 * i, n - i);
+        i += done;
+        j += done;
+        size_t end = std::min(i + UTF16_SCALAR_RUN, n);
+        while (i < end) {
+            uint16_t unit = load_unit(s, i, swap);
+            if (unit < 0x80) {
+                d[j++] = static_cast<uint8_t>(unit);
+            } else if (unit < 0x800) {
+                d[j++] = static_cast<uint8_t>(0xC0 | (unit >> 6));
+                d[j++] = static_cast<uint8_t>(0x80 | (unit & 0x3F));
+            } else if (!is_surrogate(unit)) {
+                d[j++] = static_cast<uint8_t>(0xE0 | (unit >> 12));
+                d[j++] = static_cast<uint8_t>(0x80 | ((unit >> 6) & 0x3F));
+                d[j++] = static_cast<uint8_t>(0x80 | (unit & 0x3F));
+            } else {
+                uint16_t next = i + 1 < n ? load_unit(s, i + 1, swap) : 0;
+                if (!is_high_surrogate(unit) || !is_low_surrogate(next)) {
+                    break;
+                }
+                uint32_t code = 0x10000 + ((static_cast<uint32_t>(unit) - 0xD800) << 10) + (next - 0xDC00);
+                d[j++] = static_cast<uint8_t>(0xF0 | (code >> 18));
+                d[j++] = static_cast<uint8_t>(0x80 | ((code >> 12) & 0x3F));
+                d[j++] = static_cast<uint8_t>(0x80 | ((code >> 6) & 0x3F));
+                d[j++] = static_cast<uint8_t>(0x80 | (code & 0x3F));
+                i += 1;
+            }
+            i += 1;
+        }
+        if (i < end) {
+            break;
+        }
+    }
+
+    if (written) {
+        *written = j;
+    }
+    return i;
+}
+
+// PLANES
+// ------
+
+/**
+ *  \brief Vector kernel transposing `n` elements to or from byte planes
+ *  of `n` bytes each.
+ *
+ *  Returns the number of elements transposed, and the caller
+ *  transposes the remaining tail.
+ */
+typedef size_t (*plane_kernel)(uint8_t*, const uint8_t*, size_t);
+
+
+static size_t
+plane_none(
+    uint8_t*,
+    const uint8_t*,
+    size_t
+)
+noexcept
+{
+    return 0;
+}
+
+
+/**
+ *  \brief Transpose elements `[first, n)` of `width` bytes to byte planes.
+ */
+static void
+byte_shuffle_scalar(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t first,
+    size_t n,
+    size_t width
+)
+noexcept
+{
+    for (size_t j = 0; j < width; ++j) {
+        for (size_t i = first; i < n; ++i) {
+            dst[j * n + i] = src[i * width + j];
+        }
+    }
+}
+
+
+/**
+ *  \brief Transpose byte planes back to elements `[first, n)`.
+ */
+static void
+byte_unshuffle_scalar(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t first,
+    size_t n,
+    size_t width
+)
+noexcept
+{
+    for (size_t i = first; i < n; ++i) {
+        for (size_t j = 0; j < width; ++j) {
+            dst[i * width + j] = src[j * n + i];
+        }
+    }
+}
+
+#if defined(PYCPP_BYTEORDER_X86)
+
+// PSHUFB masks gathering byte `j` of the 16 / `Width` elements in a
+// vector into the `j`-th unit of the vector, for widths 2, 4, and 8,
+// and the inverse masks scattering them back.
+alignas(16) static const uint8_t PLANE_SHUFFLE_MASK[3][16] = {
+    {0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15},
+    {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15},
+    {0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15}
+};
+
+alignas(16) static const uint8_t PLANE_UNSHUFFLE_MASK[3][16] = {
+    {0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15},
+    {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15},
+    {0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15}
+};
+
+
+/**
+ *  \brief Row of the PSHUFB masks for a width of 2, 4, or 8 bytes.
+ */
+static constexpr int
+plane_mask_index(
+    int width
+)
+noexcept
+{
+    return width == 2 ? 0 : width == 4 ? 1 : 2;
+}
+
+
+/**
+ *  \brief Transpose the `Width` x `Width` matrix of 16 / `Width`-byte
+ *  units held in `Width` vectors.
+ *
+ *  Each round interleaves row `i` with row `i + Width / 2`, which
+ *  rotates the bits of the (row, column) index by one, so log2(Width)
+ *  rounds swap rows and columns. The transpose is its own inverse.
+ */
+template <int Width>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static inline void
+transpose_ssse3(
+    __m128i* v
+)
+noexcept
+{
+    __m128i t[Width];
+    PYCPP_BYTEORDER_UNROLL
+    for (int round = 1; round < Width; round *= 2) {
+        PYCPP_BYTEORDER_UNROLL
+        for (int i = 0; i < Width / 2; ++i) {
+            __m128i a = v[i];
+            __m128i b = v[i + Width / 2];
+            if (Width == 2) {
+                t[2 * i] = _mm_unpacklo_epi64(a, b);
+                t[2 * i + 1] = _mm_unpackhi_epi64(a, b);
+            } else if (Width == 4) {
+                t[2 * i] = _mm_unpacklo_epi32(a, b);
+                t[2 * i + 1] = _mm_unpackhi_epi32(a, b);
+            } else if (Width == 8) {
+                t[2 * i] = _mm_unpacklo_epi16(a, b);
+                t[2 * i + 1] = _mm_unpackhi_epi16(a, b);
+            } else {
+                t[2 * i] = _mm_unpacklo_epi8(a, b);
+                t[2 * i + 1] = _mm_unpackhi_epi8(a, b);
+            }
+        }
+        PYCPP_BYTEORDER_UNROLL
+        for (int i = 0; i < Width; ++i) {
+            v[i] = t[i];
+        }
+    }
+}
+
+
+/**
+ *  \brief Transpose of `transpose_ssse3` within each 128-bit lane.
+ */
+template <int Width>
+PYCPP_BYTEORDER_TARGET("avx2")
+static inline void
+transpose_avx2(
+    __m256i* v
+)
+noexcept
+{
+    __m256i t[Width];
+    PYCPP_BYTEORDER_UNROLL
+    for (int round = 1; round < Width; round *= 2) {
+        PYCPP_BYTEORDER_UNROLL
+        for (int i = 0; i < Width / 2; ++i) {
+            __m256i a = v[i];
+            __m256i b = v[i + Width / 2];
+            if (Width == 2) {
+                t[2 * i] = _mm256_unpacklo_epi64(a, b);
+                t[2 * i + 1] = _mm256_unpackhi_epi64(a, b);
+            } else if (Width == 4) {
+                t[2 * i] = _mm256_unpacklo_epi32(a, b);
+                t[2 * i + 1] = _mm256_unpackhi_epi32(a, b);
+            } else if (Width == 8) {
+                t[2 * i] = _mm256_unpacklo_epi16(a, b);
+                t[2 * i + 1] = _mm256_unpackhi_epi16(a, b);
+            } else {
+                t[2 * i] = _mm256_unpacklo_epi8(a, b);
+                t[2 * i + 1] = _mm256_unpackhi_epi8(a, b);
+            }
+        }
+        PYCPP_BYTEORDER_UNROLL
+        for (int i = 0; i < Width; ++i) {
+            v[i] = t[i];
+        }
+    }
+}
+
+
+/**
+ *  \brief Transpose 16 elements at a time to byte planes.
+ *
+ *  The `Width` vectors holding 16 elements are first shuffled so each
+ *  groups its bytes by plane, and the transpose then gathers each
+ *  plane into a single vector.
+ */
+template <int Width>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+byte_shuffle_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    const uint8_t* table = PLANE_SHUFFLE_MASK[plane_mask_index(Width)];
+    __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v[Width];
+        PYCPP_BYTEORDER_UNROLL
+        for (int r = 0; r < Width; ++r) {
+            v[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * Width + 16 * r));
+            if (Width != 16) {
+                v[r] = _mm_shuffle_epi8(v[r], mask);
+            }
+        }
+        transpose_ssse3<Width>(v);
+        PYCPP_BYTEORDER_UNROLL
+        for (int j = 0; j < Width; ++j) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j * n + i), v[j]);
+        }
+    }
+
+    return i;
+}
+
+
+template <int Width>
+PYCPP_BYTEORDER_TARGET("ssse3")
+static size_t
+byte_unshuffle_ssse3(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    const uint8_t* table = PLANE_UNSHUFFLE_MASK[plane_mask_index(Width)];
+    __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v[Width];
+        PYCPP_BYTEORDER_UNROLL
+        for (int j = 0; j < Width; ++j) {
+            v[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * n + i));
+        }
+        transpose_ssse3<Width>(v);
+        PYCPP_BYTEORDER_UNROLL
+        for (int r = 0; r < Width; ++r) {
+            if (Width != 16) {
+                v[r] = _mm_shuffle_epi8(v[r], mask);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * Width + 16 * r), v[r]);
+        }
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Transpose 32 elements at a time to byte planes.
+ *
+ *  The low and high lanes hold two independent blocks of 16 elements,
+ *  so the in-lane transpose leaves each plane contiguous.
+ */
+template <int Width>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+byte_shuffle_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    const uint8_t* table = PLANE_SHUFFLE_MASK[plane_mask_index(Width)];
+    __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v[Width];
+        PYCPP_BYTEORDER_UNROLL
+        for (int r = 0; r < Width; ++r) {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * Width + 16 * r));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (i + 16) * Width + 16 * r));
+            v[r] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            if (Width != 16) {
+                v[r] = _mm256_shuffle_epi8(v[r], mask);
+            }
+        }
+        transpose_avx2<Width>(v);
+        PYCPP_BYTEORDER_UNROLL
+        for (int j = 0; j < Width; ++j) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j * n + i), v[j]);
+        }
+    }
+
+    return i;
+}
+
+
+template <int Width>
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+byte_unshuffle_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    const uint8_t* table = PLANE_UNSHUFFLE_MASK[plane_mask_index(Width)];
+    __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v[Width];
+        PYCPP_BYTEORDER_UNROLL
+        for (int j = 0; j < Width; ++j) {
+            v[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j * n + i));
+        }
+        transpose_avx2<Width>(v);
+        PYCPP_BYTEORDER_UNROLL
+        for (int r = 0; r < Width; ++r) {
+            if (Width != 16) {
+                v[r] = _mm256_shuffle_epi8(v[r], mask);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * Width + 16 * r), _mm256_castsi256_si128(v[r]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (i + 16) * Width + 16 * r), _mm256_extracti128_si256(v[r], 1));
+        }
+    }
+
+    return i;
+}
+
+#endif                  // PYCPP_BYTEORDER_X86
+
+
+#if defined(PYCPP_BYTEORDER_NEON)
+
+/**
+ *  \brief Transpose 16 elements at a time to byte planes.
+ *
+ *  VLD2 and VLD4 split 2 and 4-byte elements into planes directly.
+ *  Wider elements are split by VLD4 into vectors holding every fourth
+ *  byte, which one or two rounds of VUZP then separate into planes.
+ */
+template <int Width>
+static size_t
+byte_shuffle_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint8_t* s = src + i * Width;
+        uint8_t* d = dst + i;
+        if (Width == 2) {
+            uint8x16x2_t v = vld2q_u8(s);
+            vst1q_u8(d, v.val[0]);
+            vst1q_u8(d + n, v.val[1]);
+        } else if (Width == 4) {
+            uint8x16x4_t v = vld4q_u8(s);
+            PYCPP_BYTEORDER_UNROLL
+            for (int j = 0; j < 4; ++j) {
+                vst1q_u8(d + j * n, v.val[j]);
+            }
+        } else if (Width == 8) {
+            uint8x16x4_t a = vld4q_u8(s);
+            uint8x16x4_t b = vld4q_u8(s + 64);
+            PYCPP_BYTEORDER_UNROLL
+            for (int m = 0; m < 4; ++m) {
+                uint8x16x2_t p = vuzpq_u8(a.val[m], b.val[m]);
+                vst1q_u8(d + m * n, p.val[0]);
+                vst1q_u8(d + (m + 4) * n, p.val[1]);
+            }
+        } else {
+            uint8x16x4_t a = vld4q_u8(s);
+            uint8x16x4_t b = vld4q_u8(s + 64);
+            uint8x16x4_t c = vld4q_u8(s + 128);
+            uint8x16x4_t e = vld4q_u8(s + 192);
+            PYCPP_BYTEORDER_UNROLL
+            for (int m = 0; m < 4; ++m) {
+                uint8x16x2_t ab = vuzpq_u8(a.val[m], b.val[m]);
+                uint8x16x2_t ce = vuzpq_u8(c.val[m], e.val[m]);
+                uint8x16x2_t even = vuzpq_u8(ab.val[0], ce.val[0]);
+                uint8x16x2_t odd = vuzpq_u8(ab.val[1], ce.val[1]);
+                vst1q_u8(d + m * n, even.val[0]);
+                vst1q_u8(d + (m + 4) * n, odd.val[0]);
+                vst1q_u8(d + (m + 8) * n, even.val[1]);
+                vst1q_u8(d + (m + 12) * n, odd.val[1]);
+            }
+        }
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Inverse of `byte_shuffle_neon`, with VZIP and VST2/VST4.
+ */
+template <int Width>
+static size_t
+byte_unshuffle_neon(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t n
+)
+noexcept
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint8_t* s = src + i;
+        uint8_t* d = dst + i * Width;
+        if (Width == 2) {
+            uint8x16x2_t v;
+            v.val[0] = vld1q_u8(s);
+            v.val[1] = vld1q_u8(s + n);
+            vst2q_u8(d, v);
+        } else if (Width == 4) {
+            uint8x16x4_t v;
+            PYCPP_BYTEORDER_UNROLL
+            for (int j = 0; j < 4; ++j) {
+                v.val[j] = vld1q_u8(s + j * n);
+            }
+            vst4q_u8(d, v);
+        } else if (Width == 8) {
+            uint8x16x4_t a, b;
+            PYCPP_BYTEORDER_UNROLL
+            for (int m = 0; m < 4; ++m) {
+                uint8x16x2_t p = vzipq_u8(vld1q_u8(s + m * n), vld1q_u8(s + (m + 4) * n));
+                a.val[m] = p.val[0];
+                b.val[m] = p.val[1];
+            }
+            vst4q_u8(d, a);
+            vst4q_u8(d + 64, b);
+        } else {
+            uint8x16x4_t a, b, c, e;
+            PYCPP_BYTEORDER_UNROLL
+            for (int m = 0; m < 4; ++m) {
+                uint8x16x2_t even = vzipq_u8(vld1q_u8(s + m * n), vld1q_u8(s + (m + 8) * n));
+                uint8x16x2_t odd = vzipq_u8(vld1q_u8(s + (m + 4) * n), vld1q_u8(s + (m + 12) * n));
+                uint8x16x2_t ab = vzipq_u8(even.val[0], odd.val[0]);
+                uint8x16x2_t ce = vzipq_u8(even.val[1], odd.val[1]);
+                a.val[m] = ab.val[0];
+                b.val[m] = ab.val[1];
+                c.val[m] = ce.val[0];
+                e.val[m] = ce.val[1];
+            }
+            vst4q_u8(d, a);
+            vst4q_u8(d + 64, b);
+            vst4q_u8(d + 128, c);
+            vst4q_u8(d + 192, e);
+        }
+    }
+
+    return i;
+}
+
+#endif                  // PYCPP_BYTEORDER_NEON
+
+
+/**
+ *  \brief Byte-plane kernels for widths of 2, 4, 8, and 16 bytes.
+ */
+struct plane_dispatch
+{
+    plane_kernel shuffle[4];
+    plane_kernel unshuffle[4];
+};
+
+
+static plane_dispatch
+make_plane_dispatch()
+noexcept
+{
+    plane_dispatch table = {
+        {plane_none, plane_none, plane_none, plane_none},
+        {plane_none, plane_none, plane_none, plane_none}
+    };
+
+#if defined(PYCPP_BYTEORDER_X86)
+    cpu_features features = detect_cpu_features();
+    if (features.avx2) {
+        table = {
+            {byte_shuffle_avx2<2>, byte_shuffle_avx2<4>, byte_shuffle_avx2<8>, byte_shuffle_avx2<16>},
+            {byte_unshuffle_avx2<2>, byte_unshuffle_avx2<4>, byte_unshuffle_avx2<8>, byte_unshuffle_avx2<16>}
+        };
+    } else if (features.ssse3) {
+        table = {
+            {byte_shuffle_ssse3<2>, byte_shuffle_ssse3<4>, byte_shuffle_ssse3<8>, byte_shuffle_ssse3<16>},
+            {byte_unshuffle_ssse3<2>, byte_unshuffle_ssse3<4>, byte_unshuffle_ssse3<8>, byte_unshuffle_ssse3<16>}
+        };
+    }
+#elif defined(PYCPP_BYTEORDER_NEON)
+    table = {
+        {byte_shuffle_neon<2>, byte_shuffle_neon<4>, byte_shuffle_neon<8>, byte_shuffle_neon<16>},
+        {byte_unshuffle_neon<2>, byte_unshuffle_neon<4>, byte_unshuffle_neon<8>, byte_unshuffle_neon<16>}
+    };
+#endif
+
+    return table;
+}
+
+
+static const plane_dispatch&
+plane_kernels()
+noexcept
+{
+    static const plane_dispatch table = make_plane_dispatch();
+    return table;
+}
+
+
+/**
+ *  \brief Kernel for a width, or null if no kernel handles it.
+ */
+static plane_kernel
+plane_kernel_for(
+    const plane_kernel* kernels,
+    size_t width
+)
+noexcept
+{
+    switch (width) {
+        case 2:
+            return kernels[0];
+        case 4:
+            return kernels[1];
+        case 8:
+            return kernels[2];
+        case 16:
+            return kernels[3];
+        default:
+            return nullptr;
+    }
+}
+
+// PARALLEL
+// --------
+
+// Buffers below this size are converted on the calling thread, since
+// starting the workers costs more than the conversion itself.
+static const size_t PARALLEL_THRESHOLD = size_t(1) << 22;
+
+// Smallest number of bytes handed to a single worker.
+static const size_t PARALLEL_MIN_CHUNK = size_t(1) << 18;
+
+// Chunk boundaries are multiples of a page in the destination,
+// so no two workers store to the same page or cache line.
+static const size_t PARALLEL_PAGE_SIZE = 4096;
+
+
+static size_t
+gcd(
+    size_t a,
+    size_t b
+)
+noexcept
+{
+    while (b != 0) {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+
+/**
+ *  \brief Partition of a buffer into chunks of whole elements.
+ *
+ *  The first chunk extends to the first page boundary of the
+ *  destination, if an element boundary lies on it, and every
+ *  subsequent chunk starts on a page boundary.
+ */
+struct parallel_chunks
+{
+    size_t bytes;
+    size_t head;
+    size_t chunk;
+    size_t count;
+
+    size_t
+    begin(
+        size_t i
+    )
+    const noexcept
+    {
+        return i == 0 ? 0 : head + i * chunk;
+    }
+
+    size_t
+    end(
+        size_t i
+    )
+    const noexcept
+    {
+        return std::min(bytes, head + (i + 1) * chunk);
+    }
+};
+
+
+static parallel_chunks
+make_parallel_chunks(
+    const void* dst,
+    size_t bytes,
+    size_t width,
+    size_t threads
+)
+noexcept
+{
+    parallel_chunks chunks;
+    chunks.bytes = bytes;
+
+    size_t offset = reinterpret_cast<uintptr_t>(dst) % PARALLEL_PAGE_SIZE;
+    chunks.head = (PARALLEL_PAGE_SIZE - offset) % PARALLEL_PAGE_SIZE;
+    if (chunks.head % width != 0 || chunks.head >= bytes) {
+        chunks.head = 0;
+    }
+
+    // Oversubscribe each thread, to balance the load if the
+    // workers progress unevenly.
+    size_t unit = width / gcd(width, PARALLEL_PAGE_SIZE) * PARALLEL_PAGE_SIZE;
+    size_t chunk = std::max(bytes / (threads * 4), PARALLEL_MIN_CHUNK);
+    chunks.chunk = (chunk + unit - 1) / unit * unit;
+    chunks.count = (bytes - chunks.head + chunks.chunk - 1) / chunks.chunk;
+
+    return chunks;
+}
+
+
+/**
+ *  \brief Call `f(i)` for each `i` in `[0, count)` on up to `threads` threads.
+ *
+ *  The calling thread and `threads - 1` workers pull indices from a
+ *  shared counter. The parallel STL is not used, since it ignores the
+ *  thread count, and with libstdc++ requires linking TBB.
+ */
+template <typename F>
+static void
+parallel_for(
+    size_t count,
+    size_t threads,
+    F f
+)
+noexcept
+{
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+            f(i);
+        }
+    };
+
+    // Failing to start a worker only reduces the parallelism,
+    // since the remaining threads drain the same counter.
+    std::vector<std::thread> pool;
+    try {
+        pool.reserve(threads - 1);
+        for (size_t i = 1; i < threads; ++i) {
+            pool.emplace_back(worker);
+        }
+    } catch (...) {
+    }
+    worker();
+    for (std::thread& thread: pool) {
+        thread.join();
+    }
+}
+
+// SCATTER/GATHER
+// --------------
+
+/**
+ *  \brief Position within an array of buffer segments.
+ */
+struct iovec_cursor
+{
+    const bswap_iovec* segments;
+    size_t count;
+    size_t index;
+    size_t offset;
+
+    uint8_t*
+    data()
+    const noexcept
+    {
+        return reinterpret_cast<uint8_t*>(segments[index].iov_base) + offset;
+    }
+
+    size_t
+    available()
+    const noexcept
+    {
+        return segments[index].iov_len - offset;
+    }
+
+    /**
+     *  \brief Address of the byte `bytes` past the cursor, which may
+     *  lie in a later segment.
+     */
+    uint8_t*
+    at(
+        size_t bytes
+    )
+    const noexcept
+    {
+        size_t i = index;
+        size_t o = offset + bytes;
+        while (o >= segments[i].iov_len) {
+            o -= segments[i].iov_len;
+            ++i;
+        }
+        return reinterpret_cast<uint8_t*>(segments[i].iov_base) + o;
+    }
+
+    /**
+     *  \brief Advance the cursor, possibly into a later segment, and
+     *  skip exhausted and empty segments.
+     */
+    void
+    advance(
+        size_t bytes
+    )
+    noexcept
+    {
+        offset += bytes;
+        while (index < count && offset >= segments[index].iov_len) {
+            offset -= segments[index].iov_len;
+            ++index;
+        }
+    }
+};
+
+
+static size_t
+iovec_length(
+    const bswap_iovec* segments,
+    size_t count
+)
+noexcept
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bytes += segments[i].iov_len;
+    }
+    return bytes;
+}
+
+
+/**
+ *  \brief Byteswap `bytes` bytes from the segments of `src` to the
+ *  segments of `dst`, or in-place if `inplace`.
+ *
+ *  Each step converts the whole elements common to the current source
+ *  and destination segments with the vector kernels. Only the single
+ *  element straddling a segment boundary is swapped a byte at a time.
+ */
+static void
+memcpy_bswap_iovec(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt,
+    size_t bytes,
+    size_t width,
+    bool inplace
+)
+noexcept
+{
+    iovec_cursor d = {dst, dstcnt, 0, 0};
+    iovec_cursor s = {src, srccnt, 0, 0};
+    d.advance(0);
+    s.advance(0);
+
+    while (bytes != 0) {
+        size_t length = std::min(d.available(), s.available());
+        length -= length % width;
+        if (length != 0) {
+            bool streaming = use_streaming(d.data(), s.data(), length);
+            memcpy_bswap_width(d.data(), s.data(), length, width, streaming);
+        } else if (inplace) {
+            length = width;
+            for (size_t i = 0; i < width / 2; ++i) {
+                std::swap(*d.at(i), *d.at(width - 1 - i));
+            }
+        } else {
+            length = width;
+            for (size_t i = 0; i < width; ++i) {
+                *d.at(i) = *s.at(width - 1 - i);
+            }
+        }
+        d.advance(length);
+        s.advance(length);
+        bytes -= length;
+    }
+}
+
+// BATCHES
+// -------
+
+// Columns below this size are interleaved with other columns of the
+// same width, since they are too short to amortize a call of their own.
+static const size_t BATCH_SMALL_COLUMN = 4096;
+
+// Small columns converted together by the interleaved kernels.
+static const size_t BATCH_LANES = 4;
+
+/**
+ *  \brief Kernel converting `count` columns of one width, given by
+ *  `indices` into the columns.
+ */
+typedef void (*batch_kernel)(const bswap_column*, const size_t*, size_t);
+
+
+/**
+ *  \brief Remaining bytes of a column in an interleaved kernel.
+ */
+struct batch_lane
+{
+    uint8_t* dst;
+    const uint8_t* src;
+    size_t bytes;
+};
+
+
+#if defined(PYCPP_BYTEORDER_X86) || defined(PYCPP_BYTEORDER_NEON)
+
+// The scheduler inlines the vector swap of each ISA, so it must be
+// compiled for the same target.
+#if defined(PYCPP_BYTEORDER_X86)
+#   define PYCPP_BYTEORDER_BATCH_TARGET PYCPP_BYTEORDER_TARGET("ssse3")
+#else
+#   define PYCPP_BYTEORDER_BATCH_TARGET
+#endif
+
+/**
+ *  \brief Convert columns `BATCH_LANES` at a time, one vector from
+ *  each column per step, so independent columns share each iteration.
+ *
+ *  All lanes advance until the shortest has less than a vector left,
+ *  which is finished with scalar swaps, and its lane is refilled with
+ *  the next column. `Swap::swap` converts 16 bytes.
+ */
+template <int Width, typename Swap>
+PYCPP_BYTEORDER_BATCH_TARGET
+static void
+interleave_columns(
+    const bswap_column* columns,
+    const size_t* indices,
+    size_t count
+)
+noexcept
+{
+    batch_lane lanes[BATCH_LANES];
+    size_t active = 0;
+    size_t next = 0;
+    for (;;) {
+        while (active < BATCH_LANES && next < count) {
+            const bswap_column& column = columns[indices[next++]];
+            batch_lane& lane = lanes[active++];
+            lane.dst = reinterpret_cast<uint8_t*>(column.dst);
+            lane.src = reinterpret_cast<const uint8_t*>(column.src);
+            lane.bytes = column.bytes;
+        }
+        if (active == 0) {
+            return;
+        }
+
+        size_t steps = lanes[0].bytes / 16;
+        for (size_t k = 1; k < active; ++k) {
+            steps = std::min(steps, lanes[k].bytes / 16);
+        }
+        size_t bytes = steps * 16;
+        if (active == BATCH_LANES) {
+            for (size_t j = 0; j < bytes; j += 16) {
+                PYCPP_BYTEORDER_UNROLL
+                for (size_t k = 0; k < BATCH_LANES; ++k) {
+                    Swap::swap(lanes[k].dst + j, lanes[k].src + j);
+                }
+            }
+        } else {
+            for (size_t j = 0; j < bytes; j += 16) {
+                for (size_t k = 0; k < active; ++k) {
+                    Swap::swap(lanes[k].dst + j, lanes[k].src + j);
+                }
+            }
+        }
+
+        for (size_t k = 0; k < active;) {
+            batch_lane& lane = lanes[k];
+            lane.dst += bytes;
+            lane.src += bytes;
+            lane.bytes -= bytes;
+            if (lane.bytes < 16) {
+                bswap_scalar<Width>(lane.dst, lane.src, lane.bytes);
+                lane = lanes[--active];
+            } else {
+                ++k;
+            }
+        }
+    }
+}
+
+#endif                  // PYCPP_BYTEORDER_X86 || PYCPP_BYTEORDER_NEON
+
+
+#if defined(PYCPP_BYTEORDER_X86)
+
+template <int Width>
+struct batch_swap_ssse3
+{
+    PYCPP_BYTEORDER_TARGET("ssse3")
+    static inline void
+    swap(
+        uint8_t* dst,
+        const uint8_t* src
+    )
+    noexcept
+    {
+        const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(bswap_mask<Width>()));
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_shuffle_epi8(v, mask));
+    }
+};
+
+#endif                  // PYCPP_BYTEORDER_X86
+
+
+#if defined(PYCPP_BYTEORDER_NEON)
+
+template <int Width>
+struct batch_swap_neon
+{
+    static inline void
+    swap(
+        uint8_t* dst,
+        const uint8_t* src
+    )
+    noexcept
+    {
+        vst1q_u8(dst, neon_rev(vld1q_u8(src), std::integral_constant<int, Width>()));
+    }
+};
+
+#endif                  // PYCPP_BYTEORDER_NEON
+
+
+/**
+ *  \brief Interleaved kernels for the host CPU, for widths of 2, 4,
+ *  8, and 16 bytes, or null without vector support.
+ */
+struct batch_dispatch
+{
+    batch_kernel interleave[4];
+};
+
+
+static batch_dispatch
+make_batch_dispatch()
+noexcept
+{
+    batch_dispatch table = {{nullptr, nullptr, nullptr, nullptr}};
+
+#if defined(PYCPP_BYTEORDER_X86)
+    cpu_features features = detect_cpu_features();
+    if (features.ssse3) {
+        table.interleave[0] = interleave_columns<2, batch_swap_ssse3<2>>;
+        table.interleave[1] = interleave_columns<4, batch_swap_ssse3<4>>;
+        table.interleave[2] = interleave_columns<8, batch_swap_ssse3<8>>;
+        table.interleave[3] = interleave_columns<16, batch_swap_ssse3<16>>;
+    }
+#elif defined(PYCPP_BYTEORDER_NEON)
+    table.interleave[0] = interleave_columns<2, batch_swap_neon<2>>;
+    table.interleave[1] = interleave_columns<4, batch_swap_neon<4>>;
+    table.interleave[2] = interleave_columns<8, batch_swap_neon<8>>;
+    table.interleave[3] = interleave_columns<16, batch_swap_neon<16>>;
+#endif
+
+    return table;
+}
+
+
+/**
+ *  \brief Get the interleaved kernel for a width, or null if no kernel
+ *  handles it.
+ */
+static batch_kernel
+batch_kernel_for(
+    size_t width
+)
+noexcept
+{
+    static const batch_dispatch table = make_batch_dispatch();
+    switch (width) {
+        case 2:
+            return table.interleave[0];
+        case 4:
+            return table.interleave[1];
+        case 8:
+            return table.interleave[2];
+        case 16:
+            return table.interleave[3];
+        default:
+            return nullptr;
+    }
+}
+
+
+/**
+ *  \brief Unit of work in a batch, either `count` small columns of one
+ *  width converted by `kernel`, or bytes `[begin, end)` of one column.
+ */
+struct batch_task
+{
+    batch_kernel kernel;
+    const size_t* indices;
+    size_t count;
+    size_t begin;
+    size_t end;
+};
+
+
+static void
+run_batch_task(
+    const bswap_column* columns,
+    const batch_task& task
+)
+noexcept
+{
+    if (task.kernel) {
+        task.kernel(columns, task.indices, task.count);
+        return;
+    }
+
+    const bswap_column& column = columns[*task.indices];
+    auto* d = reinterpret_cast<uint8_t*>(column.dst);
+    auto* s = reinterpret_cast<const uint8_t*>(column.src);
+    bool streaming = use_streaming(d, s, column.bytes);
+    size_t width = static_cast<size_t>(column.width);
+    memcpy_bswap_width(d + task.begin, s + task.begin, task.end - task.begin, width, streaming);
+}
+
+
+/**
+ *  \brief Split a batch into tasks, from the columns sorted by width.
+ *
+ *  Runs of small columns of one width become interleaved tasks of up
+ *  to `PARALLEL_MIN_CHUNK` bytes, and with more than one thread,
+ *  large columns are split into the chunks of `memcpy_bswap_parallel`.
+ */
+static void
+make_batch_tasks(
+    std::vector<batch_task>& tasks,
+    const bswap_column* columns,
+    const std::vector<size_t>& order,
+    size_t threads
+)
+{
+    size_t i = 0;
+    while (i < order.size()) {
+        const bswap_column& column = columns[order[i]];
+        size_t width = static_cast<size_t>(column.width);
+        batch_kernel kernel = batch_kernel_for(width);
+        if (kernel && column.bytes < BATCH_SMALL_COLUMN) {
+            size_t first = i;
+            size_t bytes = 0;
+            while (i < order.size() && bytes < PARALLEL_MIN_CHUNK) {
+                const bswap_column& small = columns[order[i]];
+                if (static_cast<size_t>(small.width) != width || small.bytes >= BATCH_SMALL_COLUMN) {
+                    break;
+                }
+                bytes += small.bytes;
+                ++i;
+            }
+            tasks.push_back({kernel, &order[first], i - first, 0, 0});
+        } else if (threads > 1 && column.bytes >= PARALLEL_THRESHOLD) {
+            parallel_chunks chunks = make_parallel_chunks(column.dst, column.bytes, width, threads);
+            for (size_t j = 0; j < chunks.count; ++j) {
+                tasks.push_back({nullptr, &order[i], 1, chunks.begin(j), chunks.end(j)});
+            }
+            ++i;
+        } else {
+            tasks.push_back({nullptr, &order[i], 1, 0, column.bytes});
+            ++i;
+        }
+    }
+}
+
+
+/**
+ *  \brief Convert every column of a batch, grouped by width.
+ */
+static void
+memcpy_bswap_columns(
+    const bswap_column* columns,
+    size_t count,
+    size_t threads
+)
+noexcept
+{
+    std::vector<size_t> order;
+    std::vector<batch_task> tasks;
+    size_t total = 0;
+    try {
+        order.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (columns[i].bytes != 0) {
+                order.push_back(i);
+                total += columns[i].bytes;
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [columns](size_t x, size_t y) {
+            return columns[x].width < columns[y].width;
+        });
+        if (total < PARALLEL_THRESHOLD) {
+            threads = 1;
+        }
+        make_batch_tasks(tasks, columns, order, threads);
+    } catch (...) {
+        // Without memory for the tasks, convert each column in turn.
+        for (size_t i = 0; i < count; ++i) {
+            const bswap_column& column = columns[i];
+            memcpy_bswap_width(column.dst, column.src, column.bytes, static_cast<size_t>(column.width));
+        }
+        return;
+    }
+
+    if (threads == 1) {
+        for (const batch_task& task: tasks) {
+            run_batch_task(columns, task);
+        }
+    } else {
+        parallel_for(tasks.size(), std::min(threads, tasks.size()), [&](size_t i) {
+            run_batch_task(columns, tasks[i]);
+        });
+    }
+}
+
+// SELECTIONS
+// ----------
+
+// Elements ahead of the current one whose source is prefetched by
+// the scalar gather, to overlap the latency of the random loads.
+static const size_t GATHER_PREFETCH_DISTANCE = 16;
+
+/**
+ *  \brief Vector kernel gathering `n` elements selected by `indices`.
+ *
+ *  Returns the number of elements gathered, and the caller gathers
+ *  the remaining tail.
+ */
+typedef size_t (*gather_kernel)(uint8_t*, const uint8_t*, const uint32_t*, size_t);
+
+
+static size_t
+gather_none(
+    uint8_t*,
+    const uint8_t*,
+    const uint32_t*,
+    size_t
+)
+noexcept
+{
+    return 0;
+}
+
+
+static inline void
+prefetch_read(
+    const void* p
+)
+noexcept
+{
+#if defined(PYCPP_GNUC)
+    __builtin_prefetch(p, 0, 3);
+#elif defined(PYCPP_BYTEORDER_X86)
+    _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void) p;
+#endif
+}
+
+
+/**
+ *  \brief Gather and byteswap elements `[first, n)`, prefetching the
+ *  source of each element `GATHER_PREFETCH_DISTANCE` elements ahead.
+ */
+template <int Width>
+static void
+gather_scalar(
+    uint8_t* dst,
+    const uint8_t* src,
+    const uint32_t* indices,
+    size_t first,
+    size_t n
+)
+noexcept
+{
+    size_t i = first;
+    for (; i + GATHER_PREFETCH_DISTANCE < n; ++i) {
+        prefetch_read(src + size_t(indices[i + GATHER_PREFETCH_DISTANCE]) * Width);
+        bswap_element<Width>::swap(dst + i * Width, src + size_t(indices[i]) * Width);
+    }
+    for (; i < n; ++i) {
+        bswap_element<Width>::swap(dst + i * Width, src + size_t(indices[i]) * Width);
+    }
+}
+
+#if defined(PYCPP_BYTEORDER_X86)
+
+// The gathers use 64-bit offsets, zero-extended from the indices,
+// so any 32-bit index is valid, unlike the signed 32-bit offsets.
+// The AVX-512 kernels use the masked forms with every lane enabled,
+// since GCC warns on the undefined source of the unmasked forms.
+
+/**
+ *  \brief Gather 8 32-bit elements per iteration.
+ */
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+gather32_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    const uint32_t* indices,
+    size_t n
+)
+noexcept
+{
+    const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(bswap_mask<4>()));
+    const int* base = reinterpret_cast<const int*>(src);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i));
+        __m256i lo = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(idx));
+        __m256i hi = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(idx, 1));
+        __m128i a = _mm256_i64gather_epi32(base, lo, 4);
+        __m128i b = _mm256_i64gather_epi32(base, hi, 4);
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(v, mask));
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Gather 8 64-bit elements per iteration, in 2 independent gathers.
+ */
+PYCPP_BYTEORDER_TARGET("avx2")
+static size_t
+gather64_avx2(
+    uint8_t* dst,
+    const uint8_t* src,
+    const uint32_t* indices,
+    size_t n
+)
+noexcept
+{
+    const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(bswap_mask<8>()));
+    const long long* base = reinterpret_cast<const long long*>(src);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i lo = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)));
+        __m256i hi = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i + 4)));
+        __m256i a = _mm256_i64gather_epi64(base, lo, 8);
+        __m256i b = _mm256_i64gather_epi64(base, hi, 8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 8), _mm256_shuffle_epi8(a, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 8 + 32), _mm256_shuffle_epi8(b, mask));
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Gather 16 32-bit elements per iteration.
+ */
+PYCPP_BYTEORDER_TARGET("avx512f,avx512bw")
+static size_t
+gather32_avx512(
+    uint8_t* dst,
+    const uint8_t* src,
+    const uint32_t* indices,
+    size_t n
+)
+noexcept
+{
+    const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(bswap_mask<4>()));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i lo = _mm512_maskz_cvtepu32_epi64(0xff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)));
+        __m512i hi = _mm512_maskz_cvtepu32_epi64(0xff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i + 8)));
+        __m256i a = _mm512_mask_i64gather_epi32(zero, 0xff, lo, src, 4);
+        __m256i b = _mm512_mask_i64gather_epi32(zero, 0xff, hi, src, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(a, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4 + 32), _mm256_shuffle_epi8(b, mask));
+    }
+
+    return i;
+}
+
+
+/**
+ *  \brief Gather 16 64-bit elements per iteration, in 2 independent gathers.
+ */
+PYCPP_BYTEORDER_TARGET("avx512f,avx512bw")
+static size_t
+gather64_avx512(
+    uint8_t* dst,
+    const uint8_t* src,
+    const uint32_t* indices,
+    size_t n
+)
+noexcept
+{
+    const __m512i mask = _mm512_load_si512(bswap_mask<8>());
+    const __m512i zero = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i lo = _mm512_maskz_cvtepu32_epi64(0xff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)));
+        __m512i hi = _mm512_maskz_cvtepu32_epi64(0xff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i + 8)));
+        __m512i a = _mm512_mask_i64gather_epi64(zero, 0xff, lo, src, 8);
+        __m512i b = _mm512_mask_i64gather_epi64(zero, 0xff, hi, src, 8);
+        _mm512_storeu_si512(dst + i * 8, _mm512_shuffle_epi8(a, mask));
+        _mm512_storeu_si512(dst + i * 8 + 64, _mm512_shuffle_epi8(b, mask));
+    }
+
+    return i;
+}
+
+#endif                  // PYCPP_BYTEORDER_X86
+
+
+/**
+ *  \brief Gather kernels for 32 and 64-bit elements.
+ *
+ *  NEON has no gather, so other platforms use the scalar gather alone.
+ */
+struct gather_dispatch
+{
+    gather_kernel gather32;
+    gather_kernel gather64;
+};
+
+
+static gather_dispatch
+make_gather_dispatch()
+noexcept
+{
+    gather_dispatch table = {gather_none, gather_none};
+
+#if defined(PYCPP_BYTEORDER_X86)
+    cpu_features features = detect_cpu_features();
+    if (features.avx512bw) {
+        table = {gather32_avx512, gather64_avx512};
+    } else if (features.avx2) {
+        table = {gather32_avx2, gather64_avx2};
+    }
+#endif
+
+    return table;
+}
+
+
+static const gather_dispatch&
+gather_kernels()
+noexcept
+{
+    static const gather_dispatch table = make_gather_dispatch();
+    return table;
+}
+
+// FILES
+// -----
+
+// Memory budget for file conversions when none is given.
+static const size_t FILE_DEFAULT_BUDGET = size_t(1) << 26;
+
+
+/**
+ *  \brief Largest multiple of `unit` within `budget`, and at least `unit`.
+ */
+static size_t
+file_window(
+    size_t budget,
+    size_t unit
+)
+noexcept
+{
+    if (budget == 0) {
+        budget = FILE_DEFAULT_BUDGET;
+    }
+    return std::max(unit, budget / unit * unit);
+}
+
+#if defined(PYCPP_OS_POSIX)
+
+/**
+ *  \brief File descriptor closed on destruction, preserving `errno`.
+ */
+struct file_descriptor
+{
+    int fd;
+
+    file_descriptor(
+        int descriptor
+    )
+    noexcept:
+        fd(descriptor)
+    {}
+
+    ~file_descriptor()
+    noexcept
+    {
+        if (fd >= 0) {
+            int error = errno;
+            ::close(fd);
+            errno = error;
+        }
+    }
+};
+
+
+/**
+ *  \brief Mapping of a window of a file, unmapped on destruction.
+ */
+struct file_mapping
+{
+    uint8_t* data = nullptr;
+    size_t length = 0;
+
+    ~file_mapping()
+    noexcept
+    {
+        if (data) {
+            int error = errno;
+            ::munmap(data, length);
+            errno = error;
+        }
+    }
+
+    bool
+    map(
+        int fd,
+        size_t offset,
+        size_t bytes,
+        int protection
+    )
+    noexcept
+    {
+        void* address = ::mmap(nullptr, bytes, protection, MAP_SHARED, fd, static_cast<off_t>(offset));
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        data = reinterpret_cast<uint8_t*>(address);
+        length = bytes;
+#if defined(MADV_SEQUENTIAL)
+        ::madvise(data, length, MADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+};
+
+
+static size_t
+file_page_size()
+noexcept
+{
+    long size = ::sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : PARALLEL_PAGE_SIZE;
+}
+
+
+/**
+ *  \brief Drop a window of a file already read from the page cache.
+ *
+ *  The pages are clean, so they are discarded rather than written back.
+ */
+static void
+file_release_clean(
+    int fd,
+    file_mapping& mapping,
+    size_t offset
+)
+noexcept
+{
+#if defined(MADV_DONTNEED)
+    ::madvise(mapping.data, mapping.length, MADV_DONTNEED);
+#endif
+#if defined(POSIX_FADV_DONTNEED)
+    ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(mapping.length), POSIX_FADV_DONTNEED);
+#else
+    (void) fd;
+    (void) offset;
+#endif
+}
+
+
+/**
+ *  \brief Start writing back a window of converted data.
+ */
+static int
+file_writeback(
+    int fd,
+    file_mapping& mapping,
+    size_t offset
+)
+noexcept
+{
+#if defined(PYCPP_OS_LINUX) && defined(SYNC_FILE_RANGE_WRITE)
+    return ::sync_file_range(fd, static_cast<off_t>(offset), static_cast<off_t>(mapping.length), SYNC_FILE_RANGE_WRITE);
+#else
+    (void) fd;
+    (void) offset;
+    return ::msync(mapping.data, mapping.length, MS_ASYNC);
+#endif
+}
+
+
+/**
+ *  \brief Wait for the writeback of a window of converted data, and
+ *  drop it from the page cache.
+ *
+ *  Writeback of each window is started as soon as it is converted,
+ *  and only waited on after the next window, so the disk stays busy
+ *  while dirty pages stay bounded to about two windows.
+ */
+static int
+file_release_dirty(
+    int fd,
+    size_t offset,
+    size_t length
+)
+noexcept
+{
+#if defined(PYCPP_OS_LINUX) && defined(SYNC_FILE_RANGE_WRITE)
+    unsigned flags = SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER;
+    if (::sync_file_range(fd, static_cast<off_t>(offset), static_cast<off_t>(length), flags) != 0) {
+        return -1;
+    }
+#endif
+#if defined(POSIX_FADV_DONTNEED)
+    ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_DONTNEED);
+#else
+    (void) fd;
+    (void) offset;
+    (void) length;
+#endif
+    return 0;
+}
+
+
+/**
+ *  \brief Byteswap `bytes` bytes of `src` into `dst` (or in-place when
+ *  `dst == src`), one mapped window at a time.
+ */
+static int
+bswap_file_mapped(
+    int dst,
+    int src,
+    size_t bytes,
+    size_t width,
+    size_t budget
+)
+noexcept
+{
+    // Windows start on page boundaries and hold whole elements, and
+    // copies split the budget between the source and destination.
+    bool inplace = dst == src;
+    size_t page = file_page_size();
+    size_t unit = width / gcd(width, page) * page;
+    size_t window = file_window(inplace ? budget : budget / 2, unit);
+
+    size_t previous_offset = 0;
+    size_t previous_length = 0;
+    for (size_t offset = 0; offset < bytes; offset += window) {
+        size_t length = std::min(window, bytes - offset);
+        file_mapping output;
+        if (!output.map(dst, offset, length, PROT_READ | PROT_WRITE)) {
+            return -1;
+        }
+        if (inplace) {
+            memcpy_bswap_width(output.data, output.data, length, width);
+        } else {
+            file_mapping input;
+            if (!input.map(src, offset, length, PROT_READ)) {
+                return -1;
+            }
+            bool streaming = use_streaming(output.data, input.data, length);
+            memcpy_bswap_width(output.data, input.data, length, width, streaming);
+            file_release_clean(src, input, offset);
+        }
+        if (file_writeback(dst, output, offset) != 0) {
+            return -1;
+        }
+        if (previous_length != 0 && file_release_dirty(dst, previous_offset, previous_length) != 0) {
+            return -1;
+        }
+        previous_offset = offset;
+        previous_length = length;
+    }
+
+    if (previous_length != 0) {
+        return file_release_dirty(dst, previous_offset, previous_length);
+    }
+    return 0;
+}
+
+
+/**
+ *  \brief Write all of `bytes` bytes to `fd`, retrying partial writes.
+ */
+static int
+write_all(
+    int fd,
+    const uint8_t* buf,
+    size_t bytes
+)
+noexcept
+{
+    while (bytes != 0) {
+        ssize_t written = ::write(fd, buf, bytes);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0) {
+            return -1;
+        }
+        buf += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return 0;
+}
+
+#else                   // !PYCPP_OS_POSIX
+
+/**
+ *  \brief Byteswap `src` into `dst` through a buffer of `budget` bytes,
+ *  or in-place when `dst == src`.
+ */
+static int
+bswap_file_buffered(
+    FILE* dst,
+    FILE* src,
+    size_t width,
+    size_t budget
+)
+noexcept
+{
+    std::vector<uint8_t> buffer;
+    try {
+        buffer.resize(file_window(budget, width));
+    } catch (...) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    while (true) {
+        size_t bytes = std::fread(buffer.data(), 1, buffer.size(), src);
+        if (bytes == 0) {
+            return std::ferror(src) ? -1 : 0;
+        } else if (bytes % width != 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        memcpy_bswap_width(buffer.data(), buffer.data(), bytes, width);
+
+        // Streams opened for update must seek between reads and writes.
+        long offset = static_cast<long>(bytes);
+        if (dst == src && std::fseek(dst, -offset, SEEK_CUR) != 0) {
+            return -1;
+        }
+        if (std::fwrite(buffer.data(), 1, bytes, dst) != bytes) {
+            return -1;
+        }
+        if (dst == src && std::fseek(dst, 0, SEEK_CUR) != 0) {
+            return -1;
+        }
+    }
+}
+
+#endif                  // PYCPP_OS_POSIX
+
+// PIPELINES
+// ---------
+
+// Buffers in flight, and the size of each buffer, when none are given.
+static const size_t PIPELINE_DEFAULT_DEPTH = 4;
+static const size_t PIPELINE_DEFAULT_BUFFER = size_t(1) << 20;
+
+#if defined(PYCPP_OS_POSIX)
+
+/**
+ *  \brief Buffer of a pipeline, holding the `length` bytes of the
+ *  file at `offset` once `ready`.
+ *
+ *  `iov` describes the read in flight into the unfilled remainder.
+ */
+struct pipeline_slot
+{
+    uint8_t* data;
+    size_t offset;
+    size_t length;
+    size_t filled;
+    bool ready;
+    struct iovec iov;
+};
+
+
+/**
+ *  \brief Page-aligned buffers of a pipeline, unmapped on destruction.
+ */
+struct pipeline_buffers
+{
+    std::vector<pipeline_slot> slots;
+    file_mapping memory;
+
+    bool
+    allocate(
+        size_t count,
+        size_t size
+    )
+    noexcept
+    {
+        try {
+            slots.resize(count);
+        } catch (...) {
+            errno = ENOMEM;
+            return false;
+        }
+        void* address = ::mmap(nullptr, count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        memory.data = reinterpret_cast<uint8_t*>(address);
+        memory.length = count * size;
+        for (size_t i = 0; i < count; ++i) {
+            slots[i].data = memory.data + i * size;
+        }
+        return true;
+    }
+};
+
+
+/**
+ *  \brief Assign the next `size` bytes of the file from `next` to a
+ *  slot, which is no longer `ready`.
+ */
+static void
+pipeline_assign(
+    pipeline_slot& slot,
+    size_t& next,
+    size_t bytes,
+    size_t size
+)
+noexcept
+{
+    slot.offset = next;
+    slot.length = std::min(size, bytes - next);
+    slot.filled = 0;
+    next += slot.length;
+}
+
+
+/**
+ *  \brief Byteswap a filled buffer in-place and hand it to the consumer.
+ */
+static int
+pipeline_deliver(
+    pipeline_slot& slot,
+    size_t width,
+    bswap_read_callback callback,
+    void* context
+)
+noexcept
+{
+    memcpy_bswap_width(slot.data, slot.data, slot.length, width);
+    return callback(slot.data, slot.length, slot.offset, context);
+}
+
+
+/**
+ *  \brief Fill a slot with `pread`, returning 0 or the error.
+ *
+ *  Fails with `EIO` if the file ends early, since it shrank after
+ *  its size was read.
+ */
+static int
+pipeline_pread(
+    int fd,
+    pipeline_slot& slot
+)
+noexcept
+{
+    while (slot.filled < slot.length) {
+        size_t remaining = slot.length - slot.filled;
+        off_t offset = static_cast<off_t>(slot.offset + slot.filled);
+        ssize_t count = ::pread(fd, slot.data + slot.filled, remaining, offset);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0) {
+            return errno;
+        } else if (count == 0) {
+            return EIO;
+        }
+        slot.filled += static_cast<size_t>(count);
+    }
+    return 0;
+}
+
+
+/**
+ *  \brief Read, convert and deliver each buffer in turn on the
+ *  calling thread, when no reader thread can be started.
+ */
+static int
+read_bswap_serial(
+    int fd,
+    size_t bytes,
+    size_t size,
+    size_t width,
+    pipeline_slot& slot,
+    bswap_read_callback callback,
+    void* context
+)
+noexcept
+{
+    size_t next = 0;
+    while (next < bytes) {
+        pipeline_assign(slot, next, bytes, size);
+        int error = pipeline_pread(fd, slot);
+        if (error != 0) {
+            errno = error;
+            return -1;
+        }
+        int status = pipeline_deliver(slot, width, callback, context);
+        if (status != 0) {
+            return status;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ *  \brief Fill the buffers in order on a reader thread with `pread`,
+ *  while the calling thread converts and delivers the filled buffers.
+ */
+static int
+read_bswap_threaded(
+    int fd,
+    size_t bytes,
+    size_t size,
+    size_t width,
+    pipeline_buffers& buffers,
+    bswap_read_callback callback,
+    void* context
+)
+noexcept
+{
+    std::vector<pipeline_slot>& slots = buffers.slots;
+    size_t count = slots.size();
+    std::mutex mutex;
+    std::condition_variable changed;
+    int error = 0;
+    bool stop = false;
+
+    // Each slot is refilled once the consumer clears `ready`.
+    auto reader = [&]() {
+        size_t next = 0;
+        for (size_t i = 0; next < bytes; i = (i + 1) % count) {
+            pipeline_slot& slot = slots[i];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return !slot.ready || stop; });
+                if (stop) {
+                    return;
+                }
+            }
+            pipeline_assign(slot, next, bytes, size);
+            int status = pipeline_pread(fd, slot);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = status;
+                slot.ready = status == 0;
+            }
+            changed.notify_all();
+            if (status != 0) {
+                return;
+            }
+        }
+    };
+
+    std::thread thread;
+    try {
+        thread = std::thread(reader);
+    } catch (...) {
+        return read_bswap_serial(fd, bytes, size, width, slots[0], callback, context);
+    }
+
+    int status = 0;
+    size_t delivered = 0;
+    for (size_t i = 0; delivered < bytes; i = (i + 1) % count) {
+        pipeline_slot& slot = slots[i];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return slot.ready || error != 0; });
+            if (!slot.ready) {
+                status = -1;
+                break;
+            }
+        }
+        status = pipeline_deliver(slot, width, callback, context);
+        delivered += slot.length;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.ready = false;
+            stop = status != 0;
+        }
+        changed.notify_all();
+        if (status != 0) {
+            break;
+        }
+    }
+
+    thread.join();
+    if (status == -1 && error != 0) {
+        errno = error;
+    }
+    return status;
+}
+
+#if defined(PYCPP_BYTEORDER_IO_URING)
+
+/**
+ *  \brief Minimal io_uring instance, without liburing, closed and
+ *  unmapped on destruction.
+ *
+ *  Reads use `IORING_OP_READV`, the oldest read opcode, so any
+ *  kernel with io_uring supports them.
+ */
+struct uring
+{
+    int fd = -1;
+    uint8_t* sq_ring = nullptr;
+    size_t sq_ring_size = 0;
+    uint8_t* cq_ring = nullptr;
+    size_t cq_ring_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cq_mask = 0;
+    unsigned pending = 0;
+
+    ~uring()
+    noexcept
+    {
+        int error = errno;
+        if (sqes) {
+            ::munmap(sqes, sqes_size);
+        }
+        if (cq_ring && cq_ring != sq_ring) {
+            ::munmap(cq_ring, cq_ring_size);
+        }
+        if (sq_ring) {
+            ::munmap(sq_ring, sq_ring_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        errno = error;
+    }
+
+    /**
+     *  \brief Create the ring, returning false if io_uring is missing
+     *  or disabled.
+     */
+    bool
+    open(
+        unsigned entries
+    )
+    noexcept
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        }
+        sq_ring = map(sq_ring_size, IORING_OFF_SQ_RING);
+        if (!sq_ring) {
+            return false;
+        }
+        cq_ring = single ? sq_ring : map(cq_ring_size, IORING_OFF_CQ_RING);
+        if (!cq_ring) {
+            return false;
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = reinterpret_cast<io_uring_sqe*>(map(sqes_size, IORING_OFF_SQES));
+        if (!sqes) {
+            return false;
+        }
+
+        sq_tail = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+        sq_array = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+        sq_mask = *reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+        cq_head = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+        cq_mask = *reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+        return true;
+    }
+
+    uint8_t*
+    map(
+        size_t bytes,
+        off_t offset
+    )
+    noexcept
+    {
+        void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return address == MAP_FAILED ? nullptr : reinterpret_cast<uint8_t*>(address);
+    }
+
+    /**
+     *  \brief Queue a read into the unfilled remainder of a slot.
+     */
+    void
+    push(
+        int file,
+        pipeline_slot& slot,
+        size_t index
+    )
+    noexcept
+    {
+        slot.iov.iov_base = slot.data + slot.filled;
+        slot.iov.iov_len = slot.length - slot.filled;
+
+        unsigned tail = *sq_tail;
+        unsigned i = tail & sq_mask;
+        io_uring_sqe& sqe = sqes[i];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<uintptr_t>(&slot.iov);
+        sqe.len = 1;
+        sqe.off = slot.offset + slot.filled;
+        sqe.user_data = index;
+        sq_array[i] = i;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ++pending;
+    }
+
+    /**
+     *  \brief Submit the queued reads, and wait for a completion if
+     *  `wait`, returning 0 or -1 and setting `errno`.
+     */
+    int
+    enter(
+        bool wait
+    )
+    noexcept
+    {
+        unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0u;
+        long submitted;
+        do {
+            submitted = ::syscall(__NR_io_uring_enter, fd, pending, wait ? 1u : 0u, flags, nullptr, 0);
+        } while (submitted < 0 && errno == EINTR);
+        if (submitted < 0) {
+            return -1;
+        }
+        pending -= static_cast<unsigned>(submitted);
+        return 0;
+    }
+
+    bool
+    pop(
+        io_uring_cqe& cqe
+    )
+    noexcept
+    {
+        unsigned head = *cq_head;
+        if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        cqe = cqes[head & cq_mask];
+        __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+};
+
+
+/**
+ *  \brief Keep every buffer reading through io_uring, and convert and
+ *  deliver the buffers in file order as their reads complete.
+ *
+ *  Every read is waited for before returning, since the kernel
+ *  writes into the buffers until then.
+ */
+static int
+read_bswap_uring(
+    uring& ring,
+    int fd,
+    size_t bytes,
+    size_t size,
+    size_t width,
+    pipeline_buffers& buffers,
+    bswap_read_callback callback,
+    void* context
+)
+noexcept
+{
+    std::vector<pipeline_slot>& slots = buffers.slots;
+    size_t count = slots.size();
+    size_t next = 0;
+    size_t inflight = 0;
+    for (size_t i = 0; i < count; ++i) {
+        pipeline_assign(slots[i], next, bytes, size);
+        ring.push(fd, slots[i], i);
+        ++inflight;
+    }
+
+    int status = 0;
+    int error = ring.enter(false) != 0 ? errno : 0;
+    size_t delivered = 0;
+    for (size_t i = 0; delivered < bytes && error == 0; i = (i + 1) % count) {
+        pipeline_slot& slot = slots[i];
+        while (!slot.ready && error == 0) {
+            io_uring_cqe cqe;
+            if (!ring.pop(cqe)) {
+                error = ring.enter(true) != 0 ? errno : 0;
+                continue;
+            }
+            --inflight;
+            size_t index = static_cast<size_t>(cqe.user_data);
+            pipeline_slot& done = slots[index];
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                ring.push(fd, done, index);
+                ++inflight;
+            } else if (cqe.res < 0) {
+                error = -cqe.res;
+            } else if (cqe.res == 0) {
+                error = EIO;
+            } else {
+                done.filled += static_cast<size_t>(cqe.res);
+                done.ready = done.filled == done.length;
+                if (!done.ready) {
+                    ring.push(fd, done, index);
+                    ++inflight;
+                }
+            }
+            if (ring.pending != 0 && error == 0) {
+                error = ring.enter(false) != 0 ? errno : 0;
+            }
+        }
+        if (error != 0) {
+            break;
+        }
+
+        status = pipeline_deliver(slot, width, callback, context);
+        delivered += slot.length;
+        if (status != 0) {
+            break;
+        }
+        if (next < bytes) {
+            slot.ready = false;
+            pipeline_assign(slot, next, bytes, size);
+            ring.push(fd, slot, i);
+            ++inflight;
+            error = ring.enter(false) != 0 ? errno : 0;
+        }
+    }
+
+    // Waiting also submits the reads still queued, so they are
+    // counted as in flight too.
+    while (inflight != 0) {
+        io_uring_cqe cqe;
+        if (ring.pop(cqe)) {
+            --inflight;
+        } else if (ring.enter(true) != 0) {
+            break;
+        }
+    }
+
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+    return status;
+}
+
+#endif                  // PYCPP_BYTEORDER_IO_URING
+#endif                  // PYCPP_OS_POSIX
+
+// FUNCTIONS
+// ---------
+
+
+void
+memcpy_bswap16(
+    void* dst,
+    void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 2 == 0 && "Trailing data for memcpy_bswap16.");
+
+    // copy bytes
+    const bswap_dispatch& table = dispatch();
+    bool streaming = use_streaming(dst, src, bytes);
+    memcpy_bswap_fixed<2>(dst, src, bytes, table.swap16, table.stream16, streaming);
+}
+
+
+void
+memcpy_bswap32(
+    void* dst,
+    void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for memcpy_bswap32.");
+
+    // copy bytes
+    const bswap_dispatch& table = dispatch();
+    bool streaming = use_streaming(dst, src, bytes);
+    memcpy_bswap_fixed<4>(dst, src, bytes, table.swap32, table.stream32, streaming);
+}
+
+
+void
+memcpy_bswap64(
+    void* dst,
+    void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for memcpy_bswap64.");
+
+    // copy bytes
+    const bswap_dispatch& table = dispatch();
+    bool streaming = use_streaming(dst, src, bytes);
+    memcpy_bswap_fixed<8>(dst, src, bytes, table.swap64, table.stream64, streaming);
+}
+
+
+void
+memcpy_bswap24(
+    void* dst,
+    void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 3 == 0 && "Trailing data for memcpy_bswap24.");
+
+    // copy bytes
+    memcpy_bswap_width(dst, src, bytes, 3);
+}
+
+
+void
+memcpy_bswap128(
+    void* dst,
+    void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 16 == 0 && "Trailing data for memcpy_bswap128.");
+
+    // copy bytes
+    const bswap_dispatch& table = dispatch();
+    bool streaming = use_streaming(dst, src, bytes);
+    memcpy_bswap_fixed<16>(dst, src, bytes, table.swap128, table.stream128, streaming);
+}
+
+
+void
+memcpy_bswap(
+    void* dst,
+    void* src,
+    size_t bytes,
+    int width
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for memcpy_bswap.");
+    assert(bytes % width == 0 && "Trailing data for memcpy_bswap.");
+
+    // copy bytes
+    bool streaming = use_streaming(dst, src, bytes);
+    memcpy_bswap_width(dst, src, bytes, static_cast<size_t>(width), streaming);
+}
+
+
+
+void
+bswap_inplace16(
+    void* buf,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 2 == 0 && "Trailing data for bswap_inplace16.");
+
+    // swap bytes
+    const bswap_dispatch& table = dispatch();
+    memcpy_bswap_vector<2>(buf, buf, bytes, table.swap16, table.alignment);
+}
+
+
+void
+bswap_inplace32(
+    void* buf,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for bswap_inplace32.");
+
+    // swap bytes
+    const bswap_dispatch& table = dispatch();
+    memcpy_bswap_vector<4>(buf, buf, bytes, table.swap32, table.alignment);
+}
+
+
+void
+bswap_inplace64(
+    void* buf,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for bswap_inplace64.");
+
+    // swap bytes
+    const bswap_dispatch& table = dispatch();
+    memcpy_bswap_vector<8>(buf, buf, bytes, table.swap64, table.alignment);
+}
+
+
+void
+bswap_inplace24(
+    void* buf,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 3 == 0 && "Trailing data for bswap_inplace24.");
+
+    // swap bytes
+    memcpy_bswap_width(buf, buf, bytes, 3);
+}
+
+
+void
+bswap_inplace128(
+    void* buf,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 16 == 0 && "Trailing data for bswap_inplace128.");
+
+    // swap bytes
+    const bswap_dispatch& table = dispatch();
+    memcpy_bswap_vector<16>(buf, buf, bytes, table.swap128, table.alignment);
+}
+
+
+void
+bswap_inplace(
+    void* buf,
+    size_t bytes,
+    int width
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for bswap_inplace.");
+    assert(bytes % width == 0 && "Trailing data for bswap_inplace.");
+
+    // swap bytes
+    memcpy_bswap_width(buf, buf, bytes, static_cast<size_t>(width));
+}
+
+
+
+bswap_layout*
+bswap_layout_create(
+    const bswap_field* fields,
+    size_t count,
+    size_t record_size
+)
+{
+    // bounds check
+    assert(record_size > 0 && "Invalid record size for bswap_layout_create.");
+    std::vector<bswap_field> sorted(fields, fields + count);
+    std::sort(sorted.begin(), sorted.end(), [](const bswap_field& x, const bswap_field& y) {
+        return x.offset < y.offset;
+    });
+    size_t end = 0;
+    for (const bswap_field& field: sorted) {
+        assert(field.width > 0 && "Invalid width for bswap_layout_create.");
+        assert(field.offset >= end && "Overlapping fields for bswap_layout_create.");
+        end = field.offset + static_cast<size_t>(field.width);
+        assert(end <= record_size && "Field exceeds record for bswap_layout_create.");
+    }
+
+    // map each byte to its source
+    std::vector<size_t> permutation(record_size);
+    std::iota(permutation.begin(), permutation.end(), size_t(0));
+    std::vector<bswap_field> swapped;
+    for (const bswap_field& field: sorted) {
+        if (field.width == 1) {
+            continue;
+        }
+        size_t width = static_cast<size_t>(field.width);
+        for (size_t j = 0; j < width; ++j) {
+            permutation[field.offset + j] = field.offset + width - 1 - j;
+        }
+        swapped.push_back(field);
+    }
+
+    // compile layout
+    bswap_layout* layout = allocate_layout();
+    try {
+        layout->fields = std::move(swapped);
+        compile_layout(*layout, permutation);
+    } catch (...) {
+        bswap_layout_destroy(layout);
+        throw;
+    }
+
+    return layout;
+}
+
+
+bswap_layout*
+bswap_permutation_create(
+    const uint8_t* order,
+    int width
+)
+{
+    // bounds check
+    assert(width > 0 && width <= 256 && "Invalid width for bswap_permutation_create.");
+    bool seen[256] = {};
+    for (int j = 0; j < width; ++j) {
+        assert(order[j] < width && !seen[order[j]] && "Invalid byte order for bswap_permutation_create.");
+        seen[order[j]] = true;
+    }
+    (void) seen;
+
+    // compile layout
+    bswap_layout* layout = allocate_layout();
+    try {
+        compile_permutation(*layout, order, static_cast<size_t>(width));
+    } catch (...) {
+        bswap_layout_destroy(layout);
+        throw;
+    }
+
+    return layout;
+}
+
+
+void
+bswap_layout_destroy(
+    bswap_layout* layout
+)
+noexcept
+{
+    if (layout) {
+        void* allocation = layout->allocation;
+        layout->~bswap_layout();
+        ::operator delete(allocation);
+    }
+}
+
+
+void
+memcpy_bswap_records(
+    void* dst,
+    const void* src,
+    size_t records,
+    const bswap_layout* layout
+)
+noexcept
+{
+    // bounds check
+    assert(layout && "Null layout for memcpy_bswap_records.");
+
+    // copy bytes
+    memcpy_bswap_layout(dst, src, records, *layout);
+}
+
+
+void
+bswap_inplace_records(
+    void* buf,
+    size_t records,
+    const bswap_layout* layout
+)
+noexcept
+{
+    // bounds check
+    assert(layout && "Null layout for bswap_inplace_records.");
+
+    // swap bytes
+    memcpy_bswap_layout(buf, buf, records, *layout);
+}
+
+
+void
+memcpy_permute(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    const bswap_layout* layout
+)
+noexcept
+{
+    // bounds check
+    assert(layout && "Null layout for memcpy_permute.");
+    assert(bytes % layout->record_size == 0 && "Trailing data for memcpy_permute.");
+
+    // copy bytes
+    memcpy_bswap_layout(dst, src, bytes / layout->record_size, *layout);
+}
+
+
+void
+permute_inplace(
+    void* buf,
+    size_t bytes,
+    const bswap_layout* layout
+)
+noexcept
+{
+    // bounds check
+    assert(layout && "Null layout for permute_inplace.");
+    assert(bytes % layout->record_size == 0 && "Trailing data for permute_inplace.");
+
+    // swap bytes
+    memcpy_bswap_layout(buf, buf, bytes / layout->record_size, *layout);
+}
+
+
+void
+memcpy_pdptoh32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for memcpy_pdptoh32.");
+
+    // copy bytes
+    memcpy_bswap_layout(dst, src, bytes / 4, pdp32_layout());
+}
+
+
+void
+memcpy_htopdp32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for memcpy_htopdp32.");
+
+    // copy bytes
+    memcpy_bswap_layout(dst, src, bytes / 4, pdp32_layout());
+}
+
+
+void
+memcpy_fpatoh_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for memcpy_fpatoh_f64.");
+
+    // copy bytes
+    memcpy_bswap_layout(dst, src, bytes / 8, fpa64_layout());
+}
+
+
+void
+memcpy_htofpa_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for memcpy_htofpa_f64.");
+
+    // copy bytes
+    memcpy_bswap_layout(dst, src, bytes / 8, fpa64_layout());
+}
+
+
+
+void
+memcpy_htobe_f32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for memcpy_htobe_f32.");
+
+    // copy bytes
+    memcpy_convert_f32(dst, src, bytes, BIG_ENDIAN);
+}
+
+
+void
+memcpy_htole_f32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for memcpy_htole_f32.");
+
+    // copy bytes
+    memcpy_convert_f32(dst, src, bytes, LITTLE_ENDIAN);
+}
+
+
+void
+memcpy_betoh_f32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for memcpy_betoh_f32.");
+
+    // copy bytes
+    memcpy_convert_f32(dst, src, bytes, BIG_ENDIAN);
+}
+
+
+void
+memcpy_letoh_f32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for memcpy_letoh_f32.");
+
+    // copy bytes
+    memcpy_convert_f32(dst, src, bytes, LITTLE_ENDIAN);
+}
+
+
+void
+memcpy_htobe_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for memcpy_htobe_f64.");
+
+    // copy bytes
+    memcpy_convert_f64(dst, src, bytes, BIG_ENDIAN);
+}
+
+
+void
+memcpy_htole_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for memcpy_htole_f64.");
+
+    // copy bytes
+    memcpy_convert_f64(dst, src, bytes, LITTLE_ENDIAN);
+}
+
+
+void
+memcpy_betoh_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for memcpy_betoh_f64.");
+
+    // copy bytes
+    memcpy_convert_f64(dst, src, bytes, BIG_ENDIAN);
+}
+
+
+void
+memcpy_letoh_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for memcpy_letoh_f64.");
+
+    // copy bytes
+    memcpy_convert_f64(dst, src, bytes, LITTLE_ENDIAN);
+}
+
+
+
+uint32_t
+memcpy_bswap16_crc32c(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    uint32_t crc
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 2 == 0 && "Trailing data for memcpy_bswap16_crc32c.");
+
+    // copy bytes
+    return memcpy_bswap_crc32c_width(dst, src, bytes, 2, crc);
+}
+
+
+uint32_t
+memcpy_bswap32_crc32c(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    uint32_t crc
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 4 == 0 && "Trailing data for memcpy_bswap32_crc32c.");
+
+    // copy bytes
+    return memcpy_bswap_crc32c_width(dst, src, bytes, 4, crc);
+}
+
+
+uint32_t
+memcpy_bswap64_crc32c(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    uint32_t crc
+)
+noexcept
+{
+    // bounds check
+    assert(bytes % 8 == 0 && "Trailing data for memcpy_bswap64_crc32c.");
+
+    // copy bytes
+    return memcpy_bswap_crc32c_width(dst, src, bytes, 8, crc);
+}
+
+
+uint32_t
+memcpy_bswap_crc32c(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width,
+    uint32_t crc
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for memcpy_bswap_crc32c.");
+    assert(bytes % width == 0 && "Trailing data for memcpy_bswap_crc32c.");
+
+    // copy bytes
+    return memcpy_bswap_crc32c_width(dst, src, bytes, static_cast<size_t>(width), crc);
+}
+
+
+
+void
+convert_be16_to_i32(
+    int32_t* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    widen_i32<BIG_ENDIAN>(dst, src, n);
+}
+
+
+void
+convert_le16_to_i32(
+    int32_t* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    widen_i32<LITTLE_ENDIAN>(dst, src, n);
+}
+
+
+void
+convert_be16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    widen_f32<BIG_ENDIAN>(dst, src, n);
+}
+
+
+void
+convert_le16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    widen_f32<LITTLE_ENDIAN>(dst, src, n);
+}
+
+
+void
+convert_bef16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    widen_f16<BIG_ENDIAN>(dst, src, n);
+}
+
+
+void
+convert_lef16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    widen_f16<LITTLE_ENDIAN>(dst, src, n);
+}
+
+
+void
+convert_bebf16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    widen_bf16<BIG_ENDIAN>(dst, src, n);
+}
+
+
+void
+convert_lebf16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    widen_bf16<LITTLE_ENDIAN>(dst, src, n);
+}
+
+
+
+size_t
+memcpy_betoh_utf16(
+    void* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    return memcpy_utf16(dst, src, n, BIG_ENDIAN);
+}
+
+
+size_t
+memcpy_letoh_utf16(
+    void* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    // copy bytes
+    return memcpy_utf16(dst, src, n, LITTLE_ENDIAN);
+}
+
+
+size_t
+convert_utf16be_to_utf8(
+    char* dst,
+    const void* src,
+    size_t n,
+    size_t* written
+)
+noexcept
+{
+    // copy bytes
+    return convert_utf16_to_utf8(dst, src, n, written, BIG_ENDIAN);
+}
+
+
+size_t
+convert_utf16le_to_utf8(
+    char* dst,
+    const void* src,
+    size_t n,
+    size_t* written
+)
+noexcept
+{
+    // copy bytes
+    return convert_utf16_to_utf8(dst, src, n, written, LITTLE_ENDIAN);
+}
+
+
+
+void
+memcpy_bswap_parallel(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width,
+    size_t threads
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for memcpy_bswap_parallel.");
+    assert(bytes % width == 0 && "Trailing data for memcpy_bswap_parallel.");
+
+    if (threads == 0) {
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    size_t w = static_cast<size_t>(width);
+    bool streaming = use_streaming(dst, src, bytes);
+    if (threads == 1 || bytes < PARALLEL_THRESHOLD) {
+        memcpy_bswap_width(dst, src, bytes, w, streaming);
+        return;
+    }
+
+    // copy bytes
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    parallel_chunks chunks = make_parallel_chunks(d, bytes, w, threads);
+    parallel_for(chunks.count, std::min(threads, chunks.count), [&](size_t i) {
+        size_t first = chunks.begin(i);
+        size_t last = chunks.end(i);
+        memcpy_bswap_width(d + first, s + first, last - first, w, streaming);
+    });
+}
+
+
+
+size_t
+bswap_streaming_threshold()
+noexcept
+{
+    size_t threshold = STREAM_THRESHOLD.load(std::memory_order_relaxed);
+    return threshold != 0 ? threshold : default_streaming_threshold();
+}
+
+
+void
+bswap_set_streaming_threshold(
+    size_t bytes
+)
+noexcept
+{
+    STREAM_THRESHOLD.store(bytes, std::memory_order_relaxed);
+}
+
+
+void
+memcpy_bswap_stream(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for memcpy_bswap_stream.");
+    assert(bytes % width == 0 && "Trailing data for memcpy_bswap_stream.");
+
+    // copy bytes
+    memcpy_bswap_width(dst, src, bytes, static_cast<size_t>(width), dst != src);
+}
+
+
+
+void
+memcpy_bswapv16(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt
+)
+noexcept
+{
+    memcpy_bswapv(dst, dstcnt, src, srccnt, 2);
+}
+
+
+void
+memcpy_bswapv32(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt
+)
+noexcept
+{
+    memcpy_bswapv(dst, dstcnt, src, srccnt, 4);
+}
+
+
+void
+memcpy_bswapv64(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt
+)
+noexcept
+{
+    memcpy_bswapv(dst, dstcnt, src, srccnt, 8);
+}
+
+
+void
+memcpy_bswapv(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt,
+    int width
+)
+noexcept
+{
+    // bounds check
+    size_t bytes = iovec_length(src, srccnt);
+    assert(width > 0 && "Invalid width for memcpy_bswapv.");
+    assert(bytes % width == 0 && "Trailing data for memcpy_bswapv.");
+    assert(iovec_length(dst, dstcnt) >= bytes && "Destination too small for memcpy_bswapv.");
+
+    // copy bytes
+    memcpy_bswap_iovec(dst, dstcnt, src, srccnt, bytes, static_cast<size_t>(width), false);
+}
+
+
+void
+bswap_inplacev(
+    const bswap_iovec* buf,
+    size_t count,
+    int width
+)
+noexcept
+{
+    // bounds check
+    size_t bytes = iovec_length(buf, count);
+    assert(width > 0 && "Invalid width for bswap_inplacev.");
+    assert(bytes % width == 0 && "Trailing data for bswap_inplacev.");
+
+    // swap bytes
+    memcpy_bswap_iovec(buf, count, buf, count, bytes, static_cast<size_t>(width), true);
+}
+
+
+
+void
+memcpy_bswap_batch(
+    const bswap_column* columns,
+    size_t count,
+    size_t threads
+)
+noexcept
+{
+    // bounds check
+    for (size_t i = 0; i < count; ++i) {
+        assert(columns[i].width > 0 && "Invalid width for memcpy_bswap_batch.");
+        assert(columns[i].bytes % columns[i].width == 0 && "Trailing data for memcpy_bswap_batch.");
+    }
+
+    if (threads == 0) {
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    // copy bytes
+    memcpy_bswap_columns(columns, count, threads);
+}
+
+
+
+void
+gather_bswap32(
+    void* dst,
+    const void* src,
+    const uint32_t* indices,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    size_t first = gather_kernels().gather32(d, s, indices, n);
+    gather_scalar<4>(d, s, indices, first, n);
+}
+
+
+void
+gather_bswap64(
+    void* dst,
+    const void* src,
+    const uint32_t* indices,
+    size_t n
+)
+noexcept
+{
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    size_t first = gather_kernels().gather64(d, s, indices, n);
+    gather_scalar<8>(d, s, indices, first, n);
+}
+
+
+
+void
+byte_shuffle(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for byte_shuffle.");
+    assert(bytes % width == 0 && "Trailing data for byte_shuffle.");
+
+    // copy bytes
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    size_t w = static_cast<size_t>(width);
+    size_t n = bytes / w;
+    plane_kernel kernel = plane_kernel_for(plane_kernels().shuffle, w);
+    size_t first = kernel ? kernel(d, s, n) : 0;
+    byte_shuffle_scalar(d, s, first, n, w);
+}
+
+
+void
+byte_unshuffle(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for byte_unshuffle.");
+    assert(bytes % width == 0 && "Trailing data for byte_unshuffle.");
+
+    // copy bytes
+    auto* d = reinterpret_cast<uint8_t*>(dst);
+    auto* s = reinterpret_cast<const uint8_t*>(src);
+    size_t w = static_cast<size_t>(width);
+    size_t n = bytes / w;
+    plane_kernel kernel = plane_kernel_for(plane_kernels().unshuffle, w);
+    size_t first = kernel ? kernel(d, s, n) : 0;
+    byte_unshuffle_scalar(d, s, first, n, w);
+}
+
+
+
+int
+memcpy_bswap_file(
+    const char* dst,
+    const char* src,
+    int width,
+    size_t budget
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for memcpy_bswap_file.");
+
+    // copy bytes
+    size_t w = static_cast<size_t>(width);
+#if defined(PYCPP_OS_POSIX)
+    file_descriptor input(::open(src, O_RDONLY | O_CLOEXEC));
+    struct stat source;
+    if (input.fd < 0 || ::fstat(input.fd, &source) != 0) {
+        return -1;
+    }
+
+    // Pipes and devices cannot be mapped, so they are streamed instead.
+    if (!S_ISREG(source.st_mode)) {
+        file_descriptor output(::open(dst, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+        if (output.fd < 0) {
+            return -1;
+        }
+        return memcpy_bswap_fd(output.fd, input.fd, width, budget);
+    }
+
+    size_t bytes = static_cast<size_t>(source.st_size);
+    if (bytes % w != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // The destination is opened without truncating it, in case it
+    // names the source file.
+    file_descriptor output(::open(dst, O_RDWR | O_CREAT | O_CLOEXEC, 0666));
+    struct stat destination;
+    if (output.fd < 0 || ::fstat(output.fd, &destination) != 0) {
+        return -1;
+    }
+
+    // Devices and pipes cannot be truncated or mapped either, so the
+    // source is streamed into them.
+    if (!S_ISREG(destination.st_mode)) {
+        return memcpy_bswap_fd(output.fd, input.fd, width, budget);
+    }
+    if (destination.st_dev == source.st_dev && destination.st_ino == source.st_ino) {
+        return bswap_file_mapped(output.fd, output.fd, bytes, w, budget);
+    }
+
+    // Reserve the blocks up front where possible, since running out
+    // of space while writing through a mapping raises SIGBUS.
+    if (::ftruncate(output.fd, 0) != 0) {
+        return -1;
+    }
+#if defined(PYCPP_OS_LINUX)
+    if (bytes != 0 && ::posix_fallocate(output.fd, 0, static_cast<off_t>(bytes)) == 0) {
+        return bswap_file_mapped(output.fd, input.fd, bytes, w, budget);
+    }
+#endif
+    if (::ftruncate(output.fd, static_cast<off_t>(bytes)) != 0) {
+        return -1;
+    }
+    return bswap_file_mapped(output.fd, input.fd, bytes, w, budget);
+#else
+    FILE* input = std::fopen(src, "rb");
+    if (!input) {
+        return -1;
+    }
+    FILE* output = std::fopen(dst, "wb");
+    if (!output) {
+        std::fclose(input);
+        return -1;
+    }
+    int status = bswap_file_buffered(output, input, w, budget);
+    std::fclose(input);
+    if (std::fclose(output) != 0) {
+        status = -1;
+    }
+    return status;
+#endif
+}
+
+
+int
+bswap_inplace_file(
+    const char* path,
+    int width,
+    size_t budget
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for bswap_inplace_file.");
+
+    // swap bytes
+    size_t w = static_cast<size_t>(width);
+#if defined(PYCPP_OS_POSIX)
+    file_descriptor file(::open(path, O_RDWR | O_CLOEXEC));
+    struct stat info;
+    if (file.fd < 0 || ::fstat(file.fd, &info) != 0) {
+        return -1;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    if (!S_ISREG(info.st_mode) || bytes % w != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return bswap_file_mapped(file.fd, file.fd, bytes, w, budget);
+#else
+    FILE* file = std::fopen(path, "r+b");
+    if (!file) {
+        return -1;
+    }
+    int status = bswap_file_buffered(file, file, w, budget);
+    if (std::fclose(file) != 0) {
+        status = -1;
+    }
+    return status;
+#endif
+}
+
+
+int
+memcpy_bswap_fd(
+    int dst,
+    int src,
+    int width,
+    size_t budget
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for memcpy_bswap_fd.");
+
+    // copy bytes
+#if defined(PYCPP_OS_POSIX)
+    size_t w = static_cast<size_t>(width);
+    std::vector<uint8_t> buffer;
+    try {
+        buffer.resize(file_window(budget, w));
+    } catch (...) {
+        errno = ENOMEM;
+        return -1;
+    }
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(src, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    // Reads may end mid-element, so the partial element is carried
+    // over to the front of the buffer for the next read.
+    size_t offset = 0;
+    size_t carry = 0;
+    while (true) {
+        ssize_t count = ::read(src, buffer.data() + carry, buffer.size() - carry);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0) {
+            return -1;
+        } else if (count == 0) {
+            break;
+        }
+#if defined(POSIX_FADV_DONTNEED)
+        ::posix_fadvise(src, static_cast<off_t>(offset), count, POSIX_FADV_DONTNEED);
+#endif
+        offset += static_cast<size_t>(count);
+
+        size_t bytes = carry + static_cast<size_t>(count);
+        size_t whole = bytes - bytes % w;
+        memcpy_bswap_width(buffer.data(), buffer.data(), whole, w);
+        if (write_all(dst, buffer.data(), whole) != 0) {
+            return -1;
+        }
+        carry = bytes - whole;
+        std::memmove(buffer.data(), buffer.data() + whole, carry);
+    }
+
+    if (carry != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+#else
+    (void) dst;
+    (void) src;
+    (void) budget;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+
+
+int
+read_bswap_fd(
+    int fd,
+    int width,
+    bswap_read_callback callback,
+    void* context,
+    size_t depth,
+    size_t buffer_size
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for read_bswap_fd.");
+
+    // read bytes
+#if defined(PYCPP_OS_POSIX)
+    size_t w = static_cast<size_t>(width);
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        return -1;
+    } else if (!S_ISREG(info.st_mode)) {
+        errno = ESPIPE;
+        return -1;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    if (bytes % w != 0) {
+        errno = EINVAL;
+        return -1;
+    } else if (bytes == 0) {
+        return 0;
+    }
+
+    // Buffers are page-aligned and hold whole elements, and no more
+    // are allocated than the file fills.
+    size_t page = file_page_size();
+    size_t unit = w / gcd(w, page) * page;
+    size_t size = file_window(buffer_size != 0 ? buffer_size : PIPELINE_DEFAULT_BUFFER, unit);
+    size_t count = std::min(depth != 0 ? depth : PIPELINE_DEFAULT_DEPTH, (bytes + size - 1) / size);
+    pipeline_buffers buffers;
+    if (!buffers.allocate(count, size)) {
+        return -1;
+    }
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+#if defined(PYCPP_BYTEORDER_IO_URING)
+    uring ring;
+    if (count <= UINT_MAX && ring.open(static_cast<unsigned>(count))) {
+        return read_bswap_uring(ring, fd, bytes, size, w, buffers, callback, context);
+    }
+#endif
+    return read_bswap_threaded(fd, bytes, size, w, buffers, callback, context);
+#else
+    (void) fd;
+    (void) callback;
+    (void) context;
+    (void) depth;
+    (void) buffer_size;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+
+int
+read_bswap_file(
+    const char* path,
+    int width,
+    bswap_read_callback callback,
+    void* context,
+    size_t depth,
+    size_t buffer_size
+)
+noexcept
+{
+    // bounds check
+    assert(width > 0 && "Invalid width for read_bswap_file.");
+
+    // read bytes
+#if defined(PYCPP_OS_POSIX)
+    file_descriptor file(::open(path, O_RDONLY | O_CLOEXEC));
+    if (file.fd < 0) {
+        return -1;
+    }
+    return read_bswap_fd(file.fd, width, callback, context, depth, buffer_size);
+#else
+    (void) depth;
+    size_t w = static_cast<size_t>(width);
+    std::vector<uint8_t> buffer;
+    try {
+        buffer.resize(file_window(buffer_size != 0 ? buffer_size : PIPELINE_DEFAULT_BUFFER, w));
+    } catch (...) {
+        errno = ENOMEM;
+        return -1;
+    }
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+
+    int status = 0;
+    size_t offset = 0;
+    while (status == 0) {
+        size_t bytes = std::fread(buffer.data(), 1, buffer.size(), file);
+        if (bytes == 0) {
+            status = std::ferror(file) ? -1 : 0;
+            break;
+        } else if (bytes % w != 0) {
+            errno = EINVAL;
+            status = -1;
+            break;
+        }
+        memcpy_bswap_width(buffer.data(), buffer.data(), bytes, w);
+        status = callback(buffer.data(), bytes, offset, context);
+        offset += bytes;
+    }
+    std::fclose(file);
+    return status;
+#endif
+}
@@ -10,17 +10,155 @@
  *  types from host-to-endian and endian-to-host, and memcpy
  *  routines that swap the underlying byte order.
  *
+ *  The bulk memcpy routines use SSSE3, AVX2, AVX-512BW, or NEON
+ *  kernels when available, selected once from the features of the
+ *  host CPU, and only fall back to scalar swaps for the unaligned
+ *  head and the tail of the buffer.
+ *
  *  Do not prefix these macros, as they aim to provide replacements
  *  for commonly defined macros on unsupported platforms.
  *
  *  \synopsis
+ *      // CONSTEXPR BYTESWAP
+ *      template <typename T> constexpr T pycpp::byteswap(T value) noexcept;
+ *
+ *      // ENDIAN STORAGE
+ *      template <typename T, int Order> struct pycpp::endian_storage;
+ *      template <typename T> using pycpp::big_endian = endian_storage<T, BIG_ENDIAN>;
+ *      template <typename T> using pycpp::little_endian = endian_storage<T, LITTLE_ENDIAN>;
+ *      template <typename T, int Order> struct pycpp::unaligned_endian_storage;
+ *      template <typename T> using pycpp::unaligned_big_endian = unaligned_endian_storage<T, BIG_ENDIAN>;
+ *      template <typename T> using pycpp::unaligned_little_endian = unaligned_endian_storage<T, LITTLE_ENDIAN>;
+ *
  *      // CONVERSION
  *      void bswap(void* buf, int width) noexcept;
  *      void bswap(void* dst, void* src, int width) noexcept;
  *      void memcpy_bswap16(void* dst, void* src, size_t bytes) noexcept;
  *      void memcpy_bswap32(void* dst, void* src, size_t bytes) noexcept;
  *      void memcpy_bswap64(void* dst, void* src, size_t bytes) noexcept;
+ *      void memcpy_bswap24(void* dst, void* src, size_t bytes) noexcept;
+ *      void memcpy_bswap128(void* dst, void* src, size_t bytes) noexcept;
  *      void memcpy_bswap(void* dst, void* src, size_t bytes, int width) noexcept;
+ *      void bswap_inplace16(void* buf, size_t bytes) noexcept;
+ *      void bswap_inplace32(void* buf, size_t bytes) noexcept;
+ *      void bswap_inplace64(void* buf, size_t bytes) noexcept;
+ *      void bswap_inplace24(void* buf, size_t bytes) noexcept;
+ *      void bswap_inplace128(void* buf, size_t bytes) noexcept;
+ *      void bswap_inplace(void* buf, size_t bytes, int width) noexcept;
+ *      void memcpy_bswap_parallel(void* dst, const void* src, size_t bytes, int width, size_t threads = 0) noexcept;
+ *      void memcpy_bswap_stream(void* dst, const void* src, size_t bytes, int width) noexcept;
+ *      size_t bswap_streaming_threshold() noexcept;
+ *      void bswap_set_streaming_threshold(size_t bytes) noexcept;
+ *
+ *      // SCATTER/GATHER
+ *      struct bswap_iovec { void* iov_base; size_t iov_len; };
+ *      void memcpy_bswapv16(const bswap_iovec* dst, size_t dstcnt, const bswap_iovec* src, size_t srccnt) noexcept;
+ *      void memcpy_bswapv32(const bswap_iovec* dst, size_t dstcnt, const bswap_iovec* src, size_t srccnt) noexcept;
+ *      void memcpy_bswapv64(const bswap_iovec* dst, size_t dstcnt, const bswap_iovec* src, size_t srccnt) noexcept;
+ *      void memcpy_bswapv(const bswap_iovec* dst, size_t dstcnt, const bswap_iovec* src, size_t srccnt, int width) noexcept;
+ *      void bswap_inplacev(const bswap_iovec* buf, size_t count, int width) noexcept;
+ *
+ *      // BATCHES
+ *      struct bswap_column { void* dst; const void* src; size_t bytes; int width; };
+ *      void memcpy_bswap_batch(const bswap_column* columns, size_t count, size_t threads = 0) noexcept;
+ *
+ *      // SELECTIONS
+ *      void gather_bswap32(void* dst, const void* src, const uint32_t* indices, size_t n) noexcept;
+ *      void gather_bswap64(void* dst, const void* src, const uint32_t* indices, size_t n) noexcept;
+ *
+ *      // RECORDS
+ *      struct bswap_field { size_t offset; int width; };
+ *      struct bswap_layout;
+ *      bswap_layout* bswap_layout_create(const bswap_field* fields, size_t count, size_t record_size);
+ *      void bswap_layout_destroy(bswap_layout* layout) noexcept;
+ *      void memcpy_bswap_records(void* dst, const void* src, size_t records, const bswap_layout* layout) noexcept;
+ *      void bswap_inplace_records(void* buf, size_t records, const bswap_layout* layout) noexcept;
+ *
+ *      // PERMUTATIONS
+ *      bswap_layout* bswap_permutation_create(const uint8_t* order, int width);
+ *      void memcpy_permute(void* dst, const void* src, size_t bytes, const bswap_layout* layout) noexcept;
+ *      void permute_inplace(void* buf, size_t bytes, const bswap_layout* layout) noexcept;
+ *      void memcpy_pdptoh32(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_htopdp32(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_fpatoh_f64(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_htofpa_f64(void* dst, const void* src, size_t bytes) noexcept;
+ *
+ *      // FLOATS
+ *      void memcpy_htobe_f32(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_htole_f32(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_betoh_f32(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_letoh_f32(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_htobe_f64(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_htole_f64(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_betoh_f64(void* dst, const void* src, size_t bytes) noexcept;
+ *      void memcpy_letoh_f64(void* dst, const void* src, size_t bytes) noexcept;
+ *
+ *      // CHECKSUMS
+ *      uint32_t memcpy_bswap16_crc32c(void* dst, const void* src, size_t bytes, uint32_t crc = 0) noexcept;
+ *      uint32_t memcpy_bswap32_crc32c(void* dst, const void* src, size_t bytes, uint32_t crc = 0) noexcept;
+ *      uint32_t memcpy_bswap64_crc32c(void* dst, const void* src, size_t bytes, uint32_t crc = 0) noexcept;
+ *      uint32_t memcpy_bswap_crc32c(void* dst, const void* src, size_t bytes, int width, uint32_t crc = 0) noexcept;
+ *
+ *      // WIDENING
+ *      void convert_be16_to_i32(int32_t* dst, const void* src, size_t n) noexcept;
+ *      void convert_le16_to_i32(int32_t* dst, const void* src, size_t n) noexcept;
+ *      void convert_be16_to_f32(float* dst, const void* src, size_t n) noexcept;
+ *      void convert_le16_to_f32(float* dst, const void* src, size_t n) noexcept;
+ *      void convert_bef16_to_f32(float* dst, const void* src, size_t n) noexcept;
+ *      void convert_lef16_to_f32(float* dst, const void* src, size_t n) noexcept;
+ *      void convert_bebf16_to_f32(float* dst, const void* src, size_t n) noexcept;
+ *      void convert_lebf16_to_f32(float* dst, const void* src, size_t n) noexcept;
+ *
+ *      // UTF-16
+ *      size_t memcpy_betoh_utf16(void* dst, const void* src, size_t n) noexcept;
+ *      size_t memcpy_letoh_utf16(void* dst, const void* src, size_t n) noexcept;
+ *      size_t convert_utf16be_to_utf8(char* dst, const void* src, size_t n, size_t* written) noexcept;
+ *      size_t convert_utf16le_to_utf8(char* dst, const void* src, size_t n, size_t* written) noexcept;
+ *
+ *      // BYTE PLANES
+ *      void byte_shuffle(void* dst, const void* src, size_t bytes, int width) noexcept;
+ *      void byte_unshuffle(void* dst, const void* src, size_t bytes, int width) noexcept;
+ *
+ *      // FILES
+ *      int memcpy_bswap_file(const char* dst, const char* src, int width, size_t budget = 0) noexcept;
+ *      int bswap_inplace_file(const char* path, int width, size_t budget = 0) noexcept;
+ *      int memcpy_bswap_fd(int dst, int src, int width, size_t budget = 0) noexcept;
+ *
+ *      // PIPELINES
+ *      typedef int (*bswap_read_callback)(void* data, size_t bytes, size_t offset, void* context);
+ *      int read_bswap_fd(int fd, int width, bswap_read_callback callback, void* context, size_t depth = 0, size_t buffer_size = 0) noexcept;
+ *      int read_bswap_file(const char* path, int width, bswap_read_callback callback, void* context, size_t depth = 0, size_t buffer_size = 0) noexcept;
+ *
+ *      // VIEWS
+ *      template <typename T, int Order> class pycpp::endian_view;
+ *      template <typename T> using pycpp::big_endian_view = endian_view<T, BIG_ENDIAN>;
+ *      template <typename T> using pycpp::little_endian_view = endian_view<T, LITTLE_ENDIAN>;
+ *
+ *      // RANGES
+ *      template <typename T, int Order> class pycpp::endian_iterator;
+ *      template <typename T, int Order> class pycpp::endian_range;
+ *      template <typename T> using pycpp::be_iterator = endian_iterator<T, BIG_ENDIAN>;
+ *      template <typename T> using pycpp::le_iterator = endian_iterator<T, LITTLE_ENDIAN>;
+ *      template <typename T> using pycpp::be_range = endian_range<T, BIG_ENDIAN>;
+ *      template <typename T> using pycpp::le_range = endian_range<T, LITTLE_ENDIAN>;
+ *
+ *      // BITSTREAMS
+ *      class pycpp::be_bit_reader;
+ *      class pycpp::be_bit_writer;
+ *
+ *      // UNALIGNED LOAD/STORE
+ *      uint16_t load_be16(const void* src) noexcept;
+ *      uint32_t load_be32(const void* src) noexcept;
+ *      uint64_t load_be64(const void* src) noexcept;
+ *      uint16_t load_le16(const void* src) noexcept;
+ *      uint32_t load_le32(const void* src) noexcept;
+ *      uint64_t load_le64(const void* src) noexcept;
+ *      void store_be16(void* dst, uint16_t value) noexcept;
+ *      void store_be32(void* dst, uint32_t value) noexcept;
+ *      void store_be64(void* dst, uint64_t value) noexcept;
+ *      void store_le16(void* dst, uint16_t value) noexcept;
+ *      void store_le32(void* dst, uint32_t value) noexcept;
+ *      void store_le64(void* dst, uint64_t value) noexcept;
  *
  *      // DETECTION
  *      #define __BYTE_ORDER                implementation-defined
@@ -68,10 +206,44 @@
  *      #define memcpy_htole64(d, s, n)     implementation-defined
  *      #define memcpy_be64toh(d, s, n)     implementation-defined
  *      #define memcpy_le64toh(d, s, n)     implementation-defined
+ *      #define memcpy_htobe24(d, s, n)     implementation-defined
+ *      #define memcpy_htole24(d, s, n)     implementation-defined
+ *      #define memcpy_be24toh(d, s, n)     implementation-defined
+ *      #define memcpy_le24toh(d, s, n)     implementation-defined
+ *      #define memcpy_htobe128(d, s, n)    implementation-defined
+ *      #define memcpy_htole128(d, s, n)    implementation-defined
+ *      #define memcpy_be128toh(d, s, n)    implementation-defined
+ *      #define memcpy_le128toh(d, s, n)    implementation-defined
  *      #define memcpy_htobe(d, s, n, i)    implementation-defined
  *      #define memcpy_htole(d, s, n, i)    implementation-defined
  *      #define memcpy_betoh(d, s, n, i)    implementation-defined
  *      #define memcpy_letoh(d, s, n, i)    implementation-defined
+ *
+ *      // BULK IN-PLACE BYTESWAP
+ *      #define htobe16_inplace(b, n)       implementation-defined
+ *      #define htole16_inplace(b, n)       implementation-defined
+ *      #define be16toh_inplace(b, n)       implementation-defined
+ *      #define le16toh_inplace(b, n)       implementation-defined
+ *      #define htobe32_inplace(b, n)       implementation-defined
+ *      #define htole32_inplace(b, n)       implementation-defined
+ *      #define be32toh_inplace(b, n)       implementation-defined
+ *      #define le32toh_inplace(b, n)       implementation-defined
+ *      #define htobe64_inplace(b, n)       implementation-defined
+ *      #define htole64_inplace(b, n)       implementation-defined
+ *      #define be64toh_inplace(b, n)       implementation-defined
+ *      #define le64toh_inplace(b, n)       implementation-defined
+ *      #define htobe24_inplace(b, n)       implementation-defined
+ *      #define htole24_inplace(b, n)       implementation-defined
+ *      #define be24toh_inplace(b, n)       implementation-defined
+ *      #define le24toh_inplace(b, n)       implementation-defined
+ *      #define htobe128_inplace(b, n)      implementation-defined
+ *      #define htole128_inplace(b, n)      implementation-defined
+ *      #define be128toh_inplace(b, n)      implementation-defined
+ *      #define le128toh_inplace(b, n)      implementation-defined
+ *      #define htobe_inplace(b, n, i)      implementation-defined
+ *      #define htole_inplace(b, n, i)      implementation-defined
+ *      #define betoh_inplace(b, n, i)      implementation-defined
+ *      #define letoh_inplace(b, n, i)      implementation-defined
  */
 
 #pragma once
@@ -90,7 +262,10 @@
 #   define bswap32 __builtin_bswap32
 #   define bswap64 __builtin_bswap64
 #else
-#   define NEED_BSWAPXX
+/* Other compilers, which recognize the shifts in pycpp::byteswap */
+#   define bswap16(x) pycpp::byteswap(static_cast<uint16_t>(x))
+#   define bswap32(x) pycpp::byteswap(static_cast<uint32_t>(x))
+#   define bswap64(x) pycpp::byteswap(static_cast<uint64_t>(x))
 #endif
 
 #if (defined(_WIN16) || defined(_WIN32) || defined(_WIN64)) && !defined(__WINDOWS__)
@@ -218,39 +393,670 @@
 // ------
 
 #ifndef __FLOAT_WORD_ORDER
-    /* Nearly all systems use little endian floats */
-    #define __FLOAT_WORD_ORDER  LITTLE_ENDIAN
+    /* Nearly all systems store the words of a double in byte order */
+    #define __FLOAT_WORD_ORDER  BYTE_ORDER
 #endif
 
 #ifndef FLOAT_WORD_ORDER
     #define FLOAT_WORD_ORDER    __FLOAT_WORD_ORDER
 #endif
 
+// TEMPLATES
+// ---------
+
+#include <pycpp/preprocessor/compiler_traits.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pycpp
+{
+namespace byteorder_detail
+{
+// HELPERS
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 int128_type;
+__extension__ typedef unsigned __int128 uint128_type;
+#endif
+
+constexpr uint16_t
+byteswap16(
+    uint16_t v
+)
+noexcept
+{
+#if defined(PYCPP_GNUC)
+    return __builtin_bswap16(v);
+#else
+    return static_cast<uint16_t>((v >> 8) | (v << 8));
+#endif
+}
+
+
+constexpr uint32_t
+byteswap32(
+    uint32_t v
+)
+noexcept
+{
+#if defined(PYCPP_GNUC)
+    return __builtin_bswap32(v);
+#else
+    return ((v & 0xff000000u) >> 24) |
+           ((v & 0x00ff0000u) >> 8) |
+           ((v & 0x0000ff00u) << 8) |
+           ((v & 0x000000ffu) << 24);
+#endif
+}
+
+
+constexpr uint64_t
+byteswap64(
+    uint64_t v
+)
+noexcept
+{
+#if defined(PYCPP_GNUC)
+    return __builtin_bswap64(v);
+#else
+    return (static_cast<uint64_t>(byteswap32(static_cast<uint32_t>(v))) << 32) |
+           byteswap32(static_cast<uint32_t>(v >> 32));
+#endif
+}
+
+
+#if defined(__SIZEOF_INT128__)
+
+constexpr uint128_type
+byteswap128(
+    uint128_type v
+)
+noexcept
+{
+    return (static_cast<uint128_type>(byteswap64(static_cast<uint64_t>(v))) << 64) |
+           byteswap64(static_cast<uint64_t>(v >> 64));
+}
+
+#endif
+
+// TRAITS
+
+template <typename T>
+struct is_byteswap_integer: std::integral_constant<
+        bool,
+        std::is_integral<T>::value && !std::is_same<T, bool>::value
+    >
+{};
+
+#if defined(__SIZEOF_INT128__)
+
+template <>
+struct is_byteswap_integer<int128_type>: std::true_type
+{};
+
+template <>
+struct is_byteswap_integer<uint128_type>: std::true_type
+{};
+
+#endif
+
+template <typename T, size_t N = sizeof(T)>
+struct integer_byteswap;
+
+template <typename T>
+struct integer_byteswap<T, 1>
+{
+    static constexpr T apply(T v) noexcept
+    {
+        return v;
+    }
+};
+
+template <typename T>
+struct integer_byteswap<T, 2>
+{
+    static constexpr T apply(T v) noexcept
+    {
+        return static_cast<T>(byteswap16(static_cast<uint16_t>(v)));
+    }
+};
+
+template <typename T>
+struct integer_byteswap<T, 4>
+{
+    static constexpr T apply(T v) noexcept
+    {
+        return static_cast<T>(byteswap32(static_cast<uint32_t>(v)));
+    }
+};
+
+template <typename T>
+struct integer_byteswap<T, 8>
+{
+    static constexpr T apply(T v) noexcept
+    {
+        return static_cast<T>(byteswap64(static_cast<uint64_t>(v)));
+    }
+};
+
+#if defined(__SIZEOF_INT128__)
+
+template <typename T>
+struct integer_byteswap<T, 16>
+{
+    static constexpr T apply(T v) noexcept
+    {
+        return static_cast<T>(byteswap128(static_cast<uint128_type>(v)));
+    }
+};
+
+#endif
+
+template <typename T>
+struct is_byteswap_float: std::integral_constant<
+        bool,
+        std::is_floating_point<T>::value && (sizeof(T) == 4 || sizeof(T) == 8)
+    >
+{};
+
+template <typename T>
+struct float_bits
+{
+    using type = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+};
+
+// Bit casts are only constant expressions with compiler support.
+#if PYCPP_HAS_BUILTIN(__builtin_bit_cast)
+#   define PYCPP_BYTESWAP_FLOAT_CONSTEXPR constexpr
+
+template <typename To, typename From>
+constexpr To
+bit_cast(
+    const From& from
+)
+noexcept
+{
+    return __builtin_bit_cast(To, from);
+}
+
+#else
+#   define PYCPP_BYTESWAP_FLOAT_CONSTEXPR inline
+
+template <typename To, typename From>
+inline To
+bit_cast(
+    const From& from
+)
+noexcept
+{
+    To to;
+    std::memcpy(&to, &from, sizeof(To));
+    return to;
+}
+
+#endif
+
+}   /* byteorder_detail */
+
+// FUNCTIONS
+
+/**
+ *  \brief Reverse the bytes of an integer.
+ *
+ *  Lowers to a single byteswap instruction where available, and
+ *  is evaluated at compile time in constant expressions.
+ */
+template <typename T>
+constexpr typename std::enable_if<byteorder_detail::is_byteswap_integer<T>::value, T>::type
+byteswap(
+    T value
+)
+noexcept
+{
+    return byteorder_detail::integer_byteswap<T>::apply(value);
+}
+
+/**
+ *  \brief Reverse the bytes of an enumeration's underlying value.
+ */
+template <typename T>
+constexpr typename std::enable_if<std::is_enum<T>::value, T>::type
+byteswap(
+    T value
+)
+noexcept
+{
+    return static_cast<T>(byteswap(static_cast<typename std::underlying_type<T>::type>(value)));
+}
+
+/**
+ *  \brief Reverse the bytes of a float or double.
+ *
+ *  A constant expression only if the compiler supports
+ *  `__builtin_bit_cast`. The swapped value may not be a valid
+ *  number, so avoid passing it through x87 registers.
+ */
+template <typename T>
+PYCPP_BYTESWAP_FLOAT_CONSTEXPR typename std::enable_if<byteorder_detail::is_byteswap_float<T>::value, T>::type
+byteswap(
+    T value
+)
+noexcept
+{
+    using bits_type = typename byteorder_detail::float_bits<T>::type;
+    return byteorder_detail::bit_cast<T>(byteswap(byteorder_detail::bit_cast<bits_type>(value)));
+}
+
+#undef PYCPP_BYTESWAP_FLOAT_CONSTEXPR
+
+namespace byteorder_detail
+{
+// UNALIGNED
+
+/**
+ *  \brief Load a native-order integer from unaligned memory.
+ *
+ *  A fixed-size memcpy is strict-aliasing safe, and compilers lower
+ *  it, with an adjacent byteswap, to a single MOVBE or LDR+REV.
+ */
+template <typename T>
+inline T
+load_unaligned(
+    const void* src
+)
+noexcept
+{
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+
+/**
+ *  \brief Store a native-order integer to unaligned memory.
+ */
+template <typename T>
+inline void
+store_unaligned(
+    void* dst,
+    T value
+)
+noexcept
+{
+    std::memcpy(dst, &value, sizeof(T));
+}
+
+
+/**
+ *  \brief Convert between host and big-endian order.
+ */
+template <typename T>
+constexpr T
+big(
+    T value
+)
+noexcept
+{
+#if BYTE_ORDER == LITTLE_ENDIAN
+    return byteswap(value);
+#else
+    return value;
+#endif
+}
+
+
+/**
+ *  \brief Convert between host and little-endian order.
+ */
+template <typename T>
+constexpr T
+little(
+    T value
+)
+noexcept
+{
+#if BYTE_ORDER == LITTLE_ENDIAN
+    return value;
+#else
+    return byteswap(value);
+#endif
+}
+
+}   /* byteorder_detail */
+
+// STORAGE
+
+/**
+ *  \brief Value stored in a fixed byte order, converted on access.
+ *
+ *  A POD with the size and alignment of `T`, so it can describe the
+ *  aligned fields of a mapped on-disk record directly. It declares
+ *  no constructors, to stay a POD: write values through assignment,
+ *  and read them by conversion. `T` may be any type accepted by
+ *  `byteswap`. Fields of packed records may be misaligned, so use
+ *  `unaligned_endian_storage` for them instead.
+ */
+template <typename T, int Order>
+struct endian_storage
+{
+    using value_type = T;
+
+    endian_storage&
+    operator=(
+        T value
+    )
+    noexcept
+    {
+        raw = convert(value);
+        return *this;
+    }
+
+    constexpr operator T() const noexcept
+    {
+        return convert(raw);
+    }
+
+    constexpr T value() const noexcept
+    {
+        return convert(raw);
+    }
+
+    static constexpr T convert(T value) noexcept
+    {
+        return Order == BYTE_ORDER ? value : byteswap(value);
+    }
+
+    // Value in `Order`, exposed to keep the type a POD.
+    T raw;
+};
+
+template <typename T>
+using big_endian = endian_storage<T, BIG_ENDIAN>;
+
+template <typename T>
+using little_endian = endian_storage<T, LITTLE_ENDIAN>;
+
+/**
+ *  \brief Value stored in a fixed byte order with an alignment of 1.
+ *
+ *  The same interface as `endian_storage`, but the value is held as
+ *  bytes and accessed through `memcpy`, so it is valid at any address,
+ *  including as a member of a packed record.
+ */
+template <typename T, int Order>
+struct unaligned_endian_storage
+{
+    using value_type = T;
+
+    unaligned_endian_storage&
+    operator=(
+        T value
+    )
+    noexcept
+    {
+        byteorder_detail::store_unaligned(raw, endian_storage<T, Order>::convert(value));
+        return *this;
+    }
+
+    operator T() const noexcept
+    {
+        return value();
+    }
+
+    T value() const noexcept
+    {
+        return endian_storage<T, Order>::convert(byteorder_detail::load_unaligned<T>(raw));
+    }
+
+    // Bytes of the value in `Order`, exposed to keep the type a POD.
+    unsigned char raw[sizeof(T)];
+};
+
+template <typename T>
+using unaligned_big_endian = unaligned_endian_storage<T, BIG_ENDIAN>;
+
+template <typename T>
+using unaligned_little_endian = unaligned_endian_storage<T, LITTLE_ENDIAN>;
+
+}   /* pycpp */
+
 // FUNCTIONS
 // ---------
 
 #include <cstdlib>
 
+/**
+ *  \brief Swap bytes from src into dst of type sizeof(T) == width.
+ *
+ *  Widths of 2, 4, 8, and 16 bytes are swapped in registers.
+ */
+inline void
+bswap(
+    void* dst,
+    void* src,
+    int width
+)
+noexcept
+{
+    using namespace pycpp;
+    auto* d = reinterpret_cast<unsigned char*>(dst);
+    auto* s = reinterpret_cast<unsigned char*>(src);
+
+    uint64_t lo, hi;
+    uint32_t v32;
+    uint16_t v16;
+    switch (width) {
+        case 2:
+            std::memcpy(&v16, s, 2);
+            v16 = byteswap(v16);
+            std::memcpy(d, &v16, 2);
+            return;
+        case 4:
+            std::memcpy(&v32, s, 4);
+            v32 = byteswap(v32);
+            std::memcpy(d, &v32, 4);
+            return;
+        case 8:
+            std::memcpy(&lo, s, 8);
+            lo = byteswap(lo);
+            std::memcpy(d, &lo, 8);
+            return;
+        case 16:
+            std::memcpy(&lo, s, 8);
+            std::memcpy(&hi, s + 8, 8);
+            lo = byteswap(lo);
+            hi = byteswap(hi);
+            std::memcpy(d, &hi, 8);
+            std::memcpy(d + 8, &lo, 8);
+            return;
+        default:
+            if (s != d) {
+                std::memcpy(d, s, width);
+            }
+            for (int i = 0, j = width - 1; i < j; ++i, --j) {
+                unsigned char swap = d[i];
+                d[i] = d[j];
+                d[j] = swap;
+            }
+            return;
+    }
+}
+
 /**
  *  \brief Swap bytes in-place of type sizeof(T) == width.
  */
-void
+inline void
 bswap(
     void* buf,
     int width
 )
-noexcept;
+noexcept
+{
+    bswap(buf, buf, width);
+}
 
 /**
- *  \brief Swap bytes from src into dst of type sizeof(T) == width.
+ *  \brief Load a big-endian 16-bit integer from unaligned memory.
  */
-void
-bswap(
+inline uint16_t
+load_be16(
+    const void* src
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    return big(load_unaligned<uint16_t>(src));
+}
+
+/**
+ *  \brief Load a big-endian 32-bit integer from unaligned memory.
+ */
+inline uint32_t
+load_be32(
+    const void* src
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    return big(load_unaligned<uint32_t>(src));
+}
+
+/**
+ *  \brief Load a big-endian 64-bit integer from unaligned memory.
+ */
+inline uint64_t
+load_be64(
+    const void* src
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    return big(load_unaligned<uint64_t>(src));
+}
+
+/**
+ *  \brief Load a little-endian 16-bit integer from unaligned memory.
+ */
+inline uint16_t
+load_le16(
+    const void* src
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    return little(load_unaligned<uint16_t>(src));
+}
+
+/**
+ *  \brief Load a little-endian 32-bit integer from unaligned memory.
+ */
+inline uint32_t
+load_le32(
+    const void* src
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    return little(load_unaligned<uint32_t>(src));
+}
+
+/**
+ *  \brief Load a little-endian 64-bit integer from unaligned memory.
+ */
+inline uint64_t
+load_le64(
+    const void* src
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    return little(load_unaligned<uint64_t>(src));
+}
+
+/**
+ *  \brief Store a 16-bit integer as big-endian to unaligned memory.
+ */
+inline void
+store_be16(
     void* dst,
-    void* src,
-    int width
+    uint16_t value
 )
-noexcept;
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    store_unaligned<uint16_t>(dst, big(value));
+}
+
+/**
+ *  \brief Store a 32-bit integer as big-endian to unaligned memory.
+ */
+inline void
+store_be32(
+    void* dst,
+    uint32_t value
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    store_unaligned<uint32_t>(dst, big(value));
+}
+
+/**
+ *  \brief Store a 64-bit integer as big-endian to unaligned memory.
+ */
+inline void
+store_be64(
+    void* dst,
+    uint64_t value
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    store_unaligned<uint64_t>(dst, big(value));
+}
+
+/**
+ *  \brief Store a 16-bit integer as little-endian to unaligned memory.
+ */
+inline void
+store_le16(
+    void* dst,
+    uint16_t value
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    store_unaligned<uint16_t>(dst, little(value));
+}
+
+/**
+ *  \brief Store a 32-bit integer as little-endian to unaligned memory.
+ */
+inline void
+store_le32(
+    void* dst,
+    uint32_t value
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    store_unaligned<uint32_t>(dst, little(value));
+}
+
+/**
+ *  \brief Store a 64-bit integer as little-endian to unaligned memory.
+ */
+inline void
+store_le64(
+    void* dst,
+    uint64_t value
+)
+noexcept
+{
+    using namespace pycpp::byteorder_detail;
+    store_unaligned<uint64_t>(dst, little(value));
+}
 
 /**
  *  \brief memcpy() with byteswap for each 16-bit type.
@@ -285,8 +1091,36 @@ memcpy_bswap64(
 )
 noexcept;
 
+/**
+ *  \brief memcpy() with byteswap for each 24-bit type.
+ *
+ *  Converts 16 to 64 samples per vector iteration, depending on
+ *  the instruction set, for packed 24-bit audio and similar data.
+ */
+void
+memcpy_bswap24(
+    void* dst,
+    void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for each 128-bit type.
+ */
+void
+memcpy_bswap128(
+    void* dst,
+    void* src,
+    size_t bytes
+)
+noexcept;
+
 /**
  *  \brief memcpy() with byteswap for type sizeof(T) == width.
+ *
+ *  Widths of 2, 3, 4, 8, and 16 bytes use the same kernels as the
+ *  fixed-width routines, other widths use precomputed shuffle masks.
  */
 void
 memcpy_bswap(
@@ -297,34 +1131,1526 @@ memcpy_bswap(
 )
 noexcept;
 
+/**
+ *  \brief Byteswap each 16-bit type of a buffer in-place.
+ *
+ *  Uses the same vector kernels as `memcpy_bswap16`, loading and
+ *  storing through the same buffer.
+ */
+void
+bswap_inplace16(
+    void* buf,
+    size_t bytes
+)
+noexcept;
 
-#if BYTE_ORDER == LITTLE_ENDIAN
+/**
+ *  \brief Byteswap each 32-bit type of a buffer in-place.
+ */
+void
+bswap_inplace32(
+    void* buf,
+    size_t bytes
+)
+noexcept;
 
-#   define htobe(buf, i) bswap(buf, i)
-#   define htole(buf, i)
-#   define betoh(buf, i) bswap(buf, i)
-#   define letoh(buf, i)
+/**
+ *  \brief Byteswap each 64-bit type of a buffer in-place.
+ */
+void
+bswap_inplace64(
+    void* buf,
+    size_t bytes
+)
+noexcept;
 
-#   define memcpy_htobe16(dst, src, n) memcpy_bswap16(dst, src, n)
-#   define memcpy_htole16(dst, src, n) memcpy(dst, src, n)
-#   define memcpy_be16toh(dst, src, n) memcpy_bswap16(dst, src, n)
-#   define memcpy_le16toh(dst, src, n) memcpy(dst, src, n)
+/**
+ *  \brief Byteswap each 24-bit type of a buffer in-place.
+ */
+void
+bswap_inplace24(
+    void* buf,
+    size_t bytes
+)
+noexcept;
 
-#   define memcpy_htobe32(dst, src, n) memcpy_bswap32(dst, src, n)
-#   define memcpy_htole32(dst, src, n) memcpy(dst, src, n)
-#   define memcpy_be32toh(dst, src, n) memcpy_bswap32(dst, src, n)
-#   define memcpy_le32toh(dst, src, n) memcpy(dst, src, n)
+/**
+ *  \brief Byteswap each 128-bit type of a buffer in-place.
+ */
+void
+bswap_inplace128(
+    void* buf,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief Byteswap each type sizeof(T) == width of a buffer in-place.
+ */
+void
+bswap_inplace(
+    void* buf,
+    size_t bytes,
+    int width
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for type sizeof(T) == width, split
+ *  across threads.
+ *
+ *  Buffers above a few MB are split into page-aligned chunks of
+ *  whole elements, which are converted by up to `threads` threads
+ *  (the hardware concurrency if 0). Smaller buffers are converted
+ *  on the calling thread.
+ *  `dst` and `src` may be equal, but must not otherwise overlap.
+ */
+void
+memcpy_bswap_parallel(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width,
+    size_t threads = 0
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for type sizeof(T) == width, using
+ *  non-temporal stores.
+ *
+ *  The destination bypasses the cache, and the source is prefetched
+ *  with a non-temporal hint, so large conversions do not evict the
+ *  working set of other threads. Widths of 2, 4, 8, and 16 bytes
+ *  stream, other widths use the regular kernels. Copies of at least
+ *  `bswap_streaming_threshold()` bytes stream automatically.
+ */
+void
+memcpy_bswap_stream(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width
+)
+noexcept;
+
+/**
+ *  \brief Size above which byteswapped copies use non-temporal stores.
+ *
+ *  Defaults to the size of the last-level cache.
+ */
+size_t
+bswap_streaming_threshold()
+noexcept;
+
+/**
+ *  \brief Set the streaming threshold, where 0 restores the default
+ *  and SIZE_MAX disables automatic streaming.
+ */
+void
+bswap_set_streaming_threshold(
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief Buffer segment for the scatter/gather routines.
+ *
+ *  Has the same members as the POSIX `iovec`.
+ */
+struct bswap_iovec
+{
+    void* iov_base;
+    size_t iov_len;
+};
+
+/**
+ *  \brief memcpy() with byteswap for each 16-bit type, from the
+ *  segments of `src` to the segments of `dst`.
+ *
+ *  The segments on either side may have any length, and elements
+ *  split across segment boundaries are reassembled, while the bulk of
+ *  each segment uses the vector kernels. The source segments must
+ *  hold whole elements in total, and the destination segments must
+ *  have room for all of them.
+ */
+void
+memcpy_bswapv16(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for each 32-bit type, from the
+ *  segments of `src` to the segments of `dst`.
+ */
+void
+memcpy_bswapv32(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for each 64-bit type, from the
+ *  segments of `src` to the segments of `dst`.
+ */
+void
+memcpy_bswapv64(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for type sizeof(T) == width, from
+ *  the segments of `src` to the segments of `dst`.
+ */
+void
+memcpy_bswapv(
+    const bswap_iovec* dst,
+    size_t dstcnt,
+    const bswap_iovec* src,
+    size_t srccnt,
+    int width
+)
+noexcept;
+
+/**
+ *  \brief Byteswap each `width`-byte element of the segments of `buf`
+ *  in-place.
+ */
+void
+bswap_inplacev(
+    const bswap_iovec* buf,
+    size_t count,
+    int width
+)
+noexcept;
+
+/**
+ *  \brief Column of a batch conversion, which byteswaps each
+ *  `width`-byte element of `bytes` bytes from `src` into `dst`.
+ *
+ *  `dst` and `src` may be equal, but must not otherwise overlap.
+ */
+struct bswap_column
+{
+    void* dst;
+    const void* src;
+    size_t bytes;
+    int width;
+};
+
+/**
+ *  \brief memcpy() with byteswap for every column of a batch.
+ *
+ *  Converts many columns with a single call. Columns are grouped by
+ *  width, and short columns of the same width are interleaved, so
+ *  each one costs a few vector operations rather than a dispatch and
+ *  a scalar tail. Batches of at least 4 MiB are spread across up to
+ *  `threads` threads, or every hardware thread if 0. Larger columns
+ *  are split into chunks for this.
+ */
+void
+memcpy_bswap_batch(
+    const bswap_column* columns,
+    size_t count,
+    size_t threads = 0
+)
+noexcept;
+
+/**
+ *  \brief Byteswap the `n` 32-bit elements of `src` selected by
+ *  `indices` into `dst`, storing `src[indices[i]]` to `dst[i]`.
+ *
+ *  Materializes a selection vector over a big-endian column in one
+ *  pass, without a temporary. Uses AVX2 or AVX-512 gathers when
+ *  available, and otherwise scalar loads that prefetch the selected
+ *  elements ahead. `dst` must not overlap `src` or `indices`.
+ */
+void
+gather_bswap32(
+    void* dst,
+    const void* src,
+    const uint32_t* indices,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Byteswap the `n` 64-bit elements of `src` selected by
+ *  `indices` into `dst`.
+ */
+void
+gather_bswap64(
+    void* dst,
+    const void* src,
+    const uint32_t* indices,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Transpose `width`-byte elements into byte planes, storing
+ *  byte 0 of every element, then byte 1 of every element, and so on.
+ *
+ *  The Blosc-style shuffle filter, which groups the similar high bytes
+ *  of numeric data ahead of a compressor. Widths of 2, 4, 8, and 16
+ *  bytes use vector kernels. `dst` and `src` must not overlap.
+ */
+void
+byte_shuffle(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width
+)
+noexcept;
+
+/**
+ *  \brief Transpose byte planes back into `width`-byte elements,
+ *  inverting `byte_shuffle`.
+ */
+void
+byte_unshuffle(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width
+)
+noexcept;
+
+/**
+ *  \brief Byte offset and width of a field to byteswap in a record.
+ */
+struct bswap_field
+{
+    size_t offset;
+    int width;
+};
+
+/**
+ *  \brief Record layout compiled into per-record shuffle masks.
+ */
+struct bswap_layout;
+
+/**
+ *  \brief Compile the fields of a `record_size`-byte record.
+ *
+ *  Fields must not overlap, and bytes outside of any field, such as
+ *  padding, are copied unchanged. Free the layout with
+ *  `bswap_layout_destroy`.
+ */
+bswap_layout*
+bswap_layout_create(
+    const bswap_field* fields,
+    size_t count,
+    size_t record_size
+);
+
+/**
+ *  \brief Free a layout from `bswap_layout_create`.
+ */
+void
+bswap_layout_destroy(
+    bswap_layout* layout
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for each field of `records` records.
+ *
+ *  Each record costs a few vector shuffles, rather than a call per
+ *  field. `dst` and `src` may be equal, but must not otherwise overlap.
+ */
+void
+memcpy_bswap_records(
+    void* dst,
+    const void* src,
+    size_t records,
+    const bswap_layout* layout
+)
+noexcept;
+
+/**
+ *  \brief Byteswap each field of `records` records in-place.
+ */
+void
+bswap_inplace_records(
+    void* buf,
+    size_t records,
+    const bswap_layout* layout
+)
+noexcept;
+
+/**
+ *  \brief Compile an arbitrary byte order for `width`-byte elements.
+ *
+ *  Byte `j` of each converted element is byte `order[j]` of the source
+ *  element, so `{3, 2, 1, 0}` is a 32-bit byteswap, and `{1, 0, 3, 2}`
+ *  converts middle-endian (BADC) words to big-endian. `order` must
+ *  hold each index below `width` once, and `width` is at most 256.
+ *  The result is a layout, used by the record functions and freed
+ *  with `bswap_layout_destroy`.
+ */
+bswap_layout*
+bswap_permutation_create(
+    const uint8_t* order,
+    int width
+);
+
+/**
+ *  \brief memcpy() permuting the bytes of each element by `layout`.
+ *
+ *  `bytes` must be a multiple of the layout's record size. `dst` and
+ *  `src` may be equal, but must not otherwise overlap.
+ */
+void
+memcpy_permute(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    const bswap_layout* layout
+)
+noexcept;
+
+/**
+ *  \brief Permute the bytes of each element by `layout` in-place.
+ */
+void
+permute_inplace(
+    void* buf,
+    size_t bytes,
+    const bswap_layout* layout
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of 32-bit words from PDP-endian to host byte order.
+ */
+void
+memcpy_pdptoh32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of 32-bit words from host to PDP-endian byte order.
+ */
+void
+memcpy_htopdp32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of doubles from ARM FPA to host byte order.
+ *
+ *  The FPA stores the high word first, with little-endian words.
+ */
+void
+memcpy_fpatoh_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of doubles from host to ARM FPA byte order.
+ */
+void
+memcpy_htofpa_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of floats from host to big-endian byte order.
+ */
+void
+memcpy_htobe_f32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of floats from host to little-endian byte order.
+ */
+void
+memcpy_htole_f32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of floats from big-endian to host byte order.
+ */
+void
+memcpy_betoh_f32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of floats from little-endian to host byte order.
+ */
+void
+memcpy_letoh_f32(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of doubles from host to big-endian byte order.
+ *
+ *  The double conversions account for `FLOAT_WORD_ORDER`, so hosts
+ *  storing the 32-bit words of a double in the opposite order of
+ *  their bytes still produce and consume plain IEEE-754 data.
+ */
+void
+memcpy_htobe_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of doubles from host to little-endian byte order.
+ */
+void
+memcpy_htole_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of doubles from big-endian to host byte order.
+ */
+void
+memcpy_betoh_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of doubles from little-endian to host byte order.
+ */
+void
+memcpy_letoh_f64(
+    void* dst,
+    const void* src,
+    size_t bytes
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for each 16-bit type, returning the
+ *  CRC32C of the source bytes.
+ *
+ *  The checksum is computed in the same pass as the byteswap, using
+ *  the SSE4.2 or ARMv8 CRC instructions when available. Pass the
+ *  result as `crc` to extend the checksum over another buffer.
+ */
+uint32_t
+memcpy_bswap16_crc32c(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    uint32_t crc = 0
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for each 32-bit type, returning the
+ *  CRC32C of the source bytes.
+ */
+uint32_t
+memcpy_bswap32_crc32c(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    uint32_t crc = 0
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for each 64-bit type, returning the
+ *  CRC32C of the source bytes.
+ */
+uint32_t
+memcpy_bswap64_crc32c(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    uint32_t crc = 0
+)
+noexcept;
+
+/**
+ *  \brief memcpy() with byteswap for type sizeof(T) == width,
+ *  returning the CRC32C of the source bytes.
+ */
+uint32_t
+memcpy_bswap_crc32c(
+    void* dst,
+    const void* src,
+    size_t bytes,
+    int width,
+    uint32_t crc = 0
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` big-endian 16-bit signed integers to int32_t.
+ *
+ *  The widening conversions byteswap and widen in the same vector
+ *  pass, writing straight into `dst`, which must not overlap `src`.
+ */
+void
+convert_be16_to_i32(
+    int32_t* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` little-endian 16-bit signed integers to int32_t.
+ */
+void
+convert_le16_to_i32(
+    int32_t* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` big-endian 16-bit signed integers to float.
+ */
+void
+convert_be16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` little-endian 16-bit signed integers to float.
+ */
+void
+convert_le16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` big-endian IEEE half-precision floats to float.
+ *
+ *  Uses F16C when available.
+ */
+void
+convert_bef16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` little-endian IEEE half-precision floats to float.
+ */
+void
+convert_lef16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` big-endian bfloat16 values to float.
+ */
+void
+convert_bebf16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` little-endian bfloat16 values to float.
+ */
+void
+convert_lebf16_to_f32(
+    float* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of `n` big-endian UTF-16 code units to host byte
+ *  order, validating surrogate pairs in the same pass.
+ *
+ *  Returns the index of the first unpaired surrogate, or `n` if the
+ *  text is valid. Every unit is converted either way. `dst` and `src`
+ *  may be equal, but must not otherwise overlap.
+ */
+size_t
+memcpy_betoh_utf16(
+    void* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief memcpy() of `n` little-endian UTF-16 code units to host byte
+ *  order, validating surrogate pairs in the same pass.
+ */
+size_t
+memcpy_letoh_utf16(
+    void* dst,
+    const void* src,
+    size_t n
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` big-endian UTF-16 code units to UTF-8.
+ *
+ *  Returns the index of the first unpaired surrogate, or `n` if the
+ *  text is valid, and stops converting there. The number of bytes
+ *  written is stored in `written`, if not null. `dst` must hold
+ *  `3 * n` bytes, and is not null-terminated.
+ */
+size_t
+convert_utf16be_to_utf8(
+    char* dst,
+    const void* src,
+    size_t n,
+    size_t* written
+)
+noexcept;
+
+/**
+ *  \brief Convert `n` little-endian UTF-16 code units to UTF-8.
+ */
+size_t
+convert_utf16le_to_utf8(
+    char* dst,
+    const void* src,
+    size_t n,
+    size_t* written
+)
+noexcept;
+
+/**
+ *  \brief Byteswap each `width`-byte element of the file `src` into
+ *  the file `dst`, returning 0 on success or -1 and setting `errno`.
+ *
+ *  Both files are mapped and converted one window at a time, so at
+ *  most `budget` bytes (64 MiB if 0) of the files are mapped at once,
+ *  and the converted windows are written back and dropped from the
+ *  page cache as the conversion proceeds. `dst` is created or
+ *  truncated, and on POSIX systems may name `src`, which is then
+ *  converted in-place. Sources or destinations that cannot be
+ *  mapped, like pipes and devices, are streamed instead.
+ *  Fails with `EINVAL` if the size of `src` is not a multiple of
+ *  `width`.
+ */
+int
+memcpy_bswap_file(
+    const char* dst,
+    const char* src,
+    int width,
+    size_t budget = 0
+)
+noexcept;
+
+/**
+ *  \brief Byteswap each `width`-byte element of the file at `path`
+ *  in-place, returning 0 on success or -1 and setting `errno`.
+ */
+int
+bswap_inplace_file(
+    const char* path,
+    int width,
+    size_t budget = 0
+)
+noexcept;
+
+/**
+ *  \brief Byteswap each `width`-byte element read from `src` until
+ *  end-of-file and write it to `dst`, returning 0 on success or -1 and
+ *  setting `errno`.
+ *
+ *  Works for descriptors of any kind, including pipes and sockets,
+ *  through a single buffer of `budget` bytes (64 MiB if 0). Elements
+ *  split across reads are reassembled, and a partial element at the
+ *  end of the input fails with `EINVAL`. POSIX only, and fails with
+ *  `ENOSYS` elsewhere.
+ */
+int
+memcpy_bswap_fd(
+    int dst,
+    int src,
+    int width,
+    size_t budget = 0
+)
+noexcept;
+
+/**
+ *  \brief Consumer of a read pipeline, called with each converted
+ *  buffer of `bytes` bytes read from `offset` in the file, in file
+ *  order. Returns 0 to continue, or any other value to stop.
+ *
+ *  The buffer is reused once the callback returns.
+ */
+typedef int (*bswap_read_callback)(void* data, size_t bytes, size_t offset, void* context);
+
+/**
+ *  \brief Read the regular file `fd` from its start, byteswapping each
+ *  `width`-byte element, and hand it to `callback` one buffer at a
+ *  time, returning 0 on success or -1 and setting `errno`.
+ *
+ *  Reads are queued through io_uring on Linux into a ring of `depth`
+ *  page-aligned buffers (4 if 0) of `buffer_size` bytes each (1 MiB if
+ *  0, rounded to whole pages and elements), so the disk keeps reading
+ *  ahead while each completed buffer is converted and consumed on the
+ *  calling thread. Without io_uring, a reader thread fills the buffers
+ *  with `pread` instead. Returns the value of the callback if it stops
+ *  the pipeline. Fails with `ESPIPE` if `fd` is not a regular file,
+ *  and `EINVAL` if its size is not a multiple of `width`. POSIX only,
+ *  and fails with `ENOSYS` elsewhere.
+ */
+int
+read_bswap_fd(
+    int fd,
+    int width,
+    bswap_read_callback callback,
+    void* context,
+    size_t depth = 0,
+    size_t buffer_size = 0
+)
+noexcept;
+
+/**
+ *  \brief Read the file at `path` through `read_bswap_fd`.
+ *
+ *  On systems other than POSIX, the file is read and converted into a
+ *  single buffer, without overlapping the reads.
+ */
+int
+read_bswap_file(
+    const char* path,
+    int width,
+    bswap_read_callback callback,
+    void* context,
+    size_t depth = 0,
+    size_t buffer_size = 0
+)
+noexcept;
+
+// VIEWS
+// -----
+
+#include <memory>
+
+namespace pycpp
+{
+namespace byteorder_detail
+{
+/**
+ *  \brief Whether values of `T` stored in `Order` already have the
+ *  representation of the host.
+ */
+template <typename T, int Order>
+struct is_host_order: std::integral_constant<
+        bool,
+        sizeof(T) == 1 || (Order == BYTE_ORDER && (!is_byteswap_float<T>::value || sizeof(T) == 4 || FLOAT_WORD_ORDER == BYTE_ORDER))
+    >
+{};
+
+
+/**
+ *  \brief Convert `n` values of `T` from `Order` to host order.
+ */
+template <typename T, int Order>
+inline void
+convert_to_host(
+    T* dst,
+    const void* src,
+    size_t n
+)
+noexcept
+{
+    size_t bytes = n * sizeof(T);
+    if (is_byteswap_float<T>::value && sizeof(T) == 8) {
+        if (Order == BIG_ENDIAN) {
+            memcpy_betoh_f64(dst, src, bytes);
+        } else {
+            memcpy_letoh_f64(dst, src, bytes);
+        }
+    } else if (Order == BYTE_ORDER) {
+        std::memcpy(dst, src, bytes);
+    } else {
+        memcpy_bswap(dst, const_cast<void*>(src), bytes, sizeof(T));
+    }
+}
+
+
+/**
+ *  \brief Contiguous values in host order, which may own their storage.
+ */
+template <typename T>
+class endian_view_base
+{
+    static_assert(is_byteswap_integer<T>::value || std::is_enum<T>::value || is_byteswap_float<T>::value,
+        "endian_view requires an integer, enumeration, or floating-point type.");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using const_reference = const T&;
+    using const_pointer = const T*;
+    using const_iterator = const T*;
+
+    const T* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    const T* begin() const noexcept { return data_; }
+    const T* end() const noexcept { return data_ + size_; }
+    const T& operator[](size_t i) const noexcept { return data_[i]; }
+
+    /**
+     *  \brief Whether the values are read from the source bytes,
+     *  rather than from a converted copy.
+     */
+    bool is_view() const noexcept { return !buffer_; }
+
+protected:
+    /**
+     *  \brief Allocate the storage for a converted copy.
+     */
+    T*
+    allocate(
+        size_t n
+    )
+    {
+        buffer_.reset(new T[n]);
+        data_ = buffer_.get();
+        return buffer_.get();
+    }
+
+    std::unique_ptr<T[]> buffer_;
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}   /* byteorder_detail */
+
+/**
+ *  \brief Host-order values of `n` elements of `T` stored in `Order`.
+ *
+ *  Whether the source already has the host representation is known
+ *  at compile time, from `BYTE_ORDER`. If it does, the view reads the
+ *  source bytes directly, and only copies them if they are misaligned
+ *  for `T`. Otherwise, the view allocates and converts a copy with the
+ *  bulk routines. Views are movable, and a view of the source bytes
+ *  is only valid while they are. `T` may be any type accepted by
+ *  `byteswap`.
+ */
+template <typename T, int Order, bool = byteorder_detail::is_host_order<T, Order>::value>
+class endian_view;
+
+
+template <typename T, int Order>
+class endian_view<T, Order, true>: public byteorder_detail::endian_view_base<T>
+{
+public:
+    static constexpr bool zero_copy = true;
+
+    endian_view(
+        const void* src,
+        size_t n
+    )
+    {
+        this->size_ = n;
+        if (reinterpret_cast<uintptr_t>(src) % alignof(T) == 0) {
+            this->data_ = reinterpret_cast<const T*>(src);
+        } else if (n != 0) {
+            std::memcpy(this->allocate(n), src, n * sizeof(T));
+        }
+    }
+};
+
+
+template <typename T, int Order>
+class endian_view<T, Order, false>: public byteorder_detail::endian_view_base<T>
+{
+public:
+    static constexpr bool zero_copy = false;
+
+    endian_view(
+        const void* src,
+        size_t n
+    )
+    {
+        this->size_ = n;
+        if (n != 0) {
+            byteorder_detail::convert_to_host<T, Order>(this->allocate(n), src, n);
+        }
+    }
+};
+
+template <typename T>
+using big_endian_view = endian_view<T, BIG_ENDIAN>;
+
+template <typename T>
+using little_endian_view = endian_view<T, LITTLE_ENDIAN>;
+
+}   /* pycpp */
+
+// RANGES
+// ------
+
+#include <cstddef>
+#include <iterator>
+
+namespace pycpp
+{
+/**
+ *  \brief Random-access iterator over values of `T` stored in `Order`,
+ *  converted to host order on each dereference.
+ *
+ *  The source needs no alignment, and each dereference is a single
+ *  unaligned load and byteswap, which compilers vectorize in loops.
+ *  Dereferencing yields values rather than references, so the range
+ *  is read-only; it still declares random-access iterators so the
+ *  standard and parallel algorithms accept it.
+ */
+template <typename T, int Order>
+class endian_iterator
+{
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    endian_iterator() noexcept = default;
+
+    explicit
+    endian_iterator(
+        const void* ptr
+    )
+    noexcept:
+        ptr_(reinterpret_cast<const unsigned char*>(ptr))
+    {}
+
+    const void* base() const noexcept { return ptr_; }
+
+    T
+    operator*()
+    const noexcept
+    {
+        return endian_storage<T, Order>::convert(byteorder_detail::load_unaligned<T>(ptr_));
+    }
+
+    T
+    operator[](
+        difference_type n
+    )
+    const noexcept
+    {
+        return *(*this + n);
+    }
+
+    endian_iterator& operator++() noexcept { ptr_ += sizeof(T); return *this; }
+    endian_iterator& operator--() noexcept { ptr_ -= sizeof(T); return *this; }
+    endian_iterator operator++(int) noexcept { endian_iterator copy(*this); ++*this; return copy; }
+    endian_iterator operator--(int) noexcept { endian_iterator copy(*this); --*this; return copy; }
+    endian_iterator& operator+=(difference_type n) noexcept { ptr_ += n * difference_type(sizeof(T)); return *this; }
+    endian_iterator& operator-=(difference_type n) noexcept { ptr_ -= n * difference_type(sizeof(T)); return *this; }
+
+    friend endian_iterator operator+(endian_iterator it, difference_type n) noexcept { return it += n; }
+    friend endian_iterator operator+(difference_type n, endian_iterator it) noexcept { return it += n; }
+    friend endian_iterator operator-(endian_iterator it, difference_type n) noexcept { return it -= n; }
+
+    friend difference_type
+    operator-(
+        const endian_iterator& lhs,
+        const endian_iterator& rhs
+    )
+    noexcept
+    {
+        return (lhs.ptr_ - rhs.ptr_) / difference_type(sizeof(T));
+    }
+
+    friend bool operator==(const endian_iterator& lhs, const endian_iterator& rhs) noexcept { return lhs.ptr_ == rhs.ptr_; }
+    friend bool operator!=(const endian_iterator& lhs, const endian_iterator& rhs) noexcept { return lhs.ptr_ != rhs.ptr_; }
+    friend bool operator<(const endian_iterator& lhs, const endian_iterator& rhs) noexcept { return lhs.ptr_ < rhs.ptr_; }
+    friend bool operator<=(const endian_iterator& lhs, const endian_iterator& rhs) noexcept { return lhs.ptr_ <= rhs.ptr_; }
+    friend bool operator>(const endian_iterator& lhs, const endian_iterator& rhs) noexcept { return lhs.ptr_ > rhs.ptr_; }
+    friend bool operator>=(const endian_iterator& lhs, const endian_iterator& rhs) noexcept { return lhs.ptr_ >= rhs.ptr_; }
+
+private:
+    const unsigned char* ptr_ = nullptr;
+};
+
+
+/**
+ *  \brief Range of `n` values of `T` stored in `Order` at `ptr`,
+ *  converted lazily on access.
+ */
+template <typename T, int Order>
+class endian_range
+{
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = endian_iterator<T, Order>;
+    using const_iterator = iterator;
+
+    endian_range(
+        const void* ptr,
+        size_t n
+    )
+    noexcept:
+        first_(ptr),
+        last_(first_ + static_cast<difference_type>(n))
+    {}
+
+    iterator begin() const noexcept { return first_; }
+    iterator end() const noexcept { return last_; }
+    size_t size() const noexcept { return static_cast<size_t>(last_ - first_); }
+    bool empty() const noexcept { return first_ == last_; }
+    T operator[](size_t i) const noexcept { return first_[static_cast<difference_type>(i)]; }
+    T front() const noexcept { return *first_; }
+    T back() const noexcept { return *(last_ - 1); }
+
+private:
+    iterator first_;
+    iterator last_;
+};
+
+template <typename T>
+using be_iterator = endian_iterator<T, BIG_ENDIAN>;
+
+template <typename T>
+using le_iterator = endian_iterator<T, LITTLE_ENDIAN>;
+
+template <typename T>
+using be_range = endian_range<T, BIG_ENDIAN>;
+
+template <typename T>
+using le_range = endian_range<T, LITTLE_ENDIAN>;
+
+}   /* pycpp */
+
+// BITSTREAMS
+// ----------
+
+#include <algorithm>
+
+namespace pycpp
+{
+/**
+ *  \brief Reader of big-endian (most-significant bit first) bitstreams.
+ *
+ *  Each refill is a single unaligned 64-bit load and byteswap, shifted
+ *  past the bits already consumed in the first byte, so at least 57
+ *  bits are available after it. `peek` and `consume` never branch,
+ *  and may be called repeatedly between refills as long as the bits
+ *  consumed stay within those 57. `read` and `skip` refill first.
+ *
+ *  Refills take a branch-free path while 8 bytes remain in the buffer,
+ *  and only the final bytes are loaded one by one. Reading past the end
+ *  of the buffer yields zero bits, and sets `overrun`.
+ */
+class be_bit_reader
+{
+public:
+    be_bit_reader(
+        const void* buf,
+        size_t bytes
+    )
+    noexcept:
+        first_(reinterpret_cast<const unsigned char*>(buf)),
+        ptr_(first_),
+        last_(first_ + bytes)
+    {
+        refill();
+    }
+
+    /**
+     *  \brief Load the next bits into the register.
+     */
+    void
+    refill()
+    noexcept
+    {
+        size_t bytes = std::min<size_t>(bitpos_ >> 3, static_cast<size_t>(last_ - ptr_));
+        ptr_ += bytes;
+        bitpos_ -= bytes << 3;
+        if (last_ - ptr_ >= 8) {
+            bitbuf_ = load_be64(ptr_) << bitpos_;
+        } else {
+            refill_tail();
+        }
+    }
+
+    /**
+     *  \brief Next `n` bits, for `n` in [1, 57], without consuming them.
+     */
+    uint64_t
+    peek(
+        unsigned n
+    )
+    const noexcept
+    {
+        return bitbuf_ >> (64 - n);
+    }
+
+    /**
+     *  \brief Consume `n` bits, for `n` in [1, 57], without refilling.
+     */
+    void
+    consume(
+        unsigned n
+    )
+    noexcept
+    {
+        bitbuf_ <<= n;
+        bitpos_ += n;
+    }
+
+    /**
+     *  \brief Read the next `n` bits, for `n` in [1, 57].
+     */
+    uint64_t
+    read(
+        unsigned n
+    )
+    noexcept
+    {
+        refill();
+        uint64_t value = peek(n);
+        consume(n);
+        return value;
+    }
+
+    /**
+     *  \brief Skip any number of bits.
+     */
+    void
+    skip(
+        size_t n
+    )
+    noexcept
+    {
+        bitpos_ += n;
+        refill();
+    }
+
+    /**
+     *  \brief Skip to the next byte boundary.
+     */
+    void
+    align()
+    noexcept
+    {
+        skip((8 - (bitpos_ & 7)) & 7);
+    }
+
+    /**
+     *  \brief Number of bits consumed.
+     */
+    size_t
+    position()
+    const noexcept
+    {
+        return static_cast<size_t>(ptr_ - first_) * 8 + bitpos_;
+    }
+
+    /**
+     *  \brief Number of bits remaining, negative after an overrun.
+     */
+    std::ptrdiff_t
+    bits_left()
+    const noexcept
+    {
+        return static_cast<std::ptrdiff_t>(last_ - first_) * 8 - static_cast<std::ptrdiff_t>(position());
+    }
+
+    /**
+     *  \brief Whether more bits were consumed than the buffer holds.
+     */
+    bool
+    overrun()
+    const noexcept
+    {
+        return bits_left() < 0;
+    }
+
+private:
+    void
+    refill_tail()
+    noexcept
+    {
+        // Past the end, `bitpos_` keeps counting the overrun.
+        unsigned char tail[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        if (ptr_ != last_) {
+            std::memcpy(tail, ptr_, static_cast<size_t>(last_ - ptr_));
+        }
+        bitbuf_ = bitpos_ < 64 ? load_be64(tail) << bitpos_ : 0;
+    }
+
+    const unsigned char* first_;
+    const unsigned char* ptr_;
+    const unsigned char* last_;
+    uint64_t bitbuf_ = 0;
+    size_t bitpos_ = 0;
+};
+
+
+/**
+ *  \brief Writer of big-endian (most-significant bit first) bitstreams.
+ *
+ *  Each write shifts the bits into a 64-bit register, and stores the
+ *  register with a single byteswap and unaligned 64-bit store, keeping
+ *  only the partial final byte, so writes of up to 57 bits never
+ *  branch while 8 bytes of room remain. Writes beyond the end of the
+ *  buffer are dropped, and set `overflow`. Call `flush` to write the
+ *  final partial byte, padded with zero bits.
+ */
+class be_bit_writer
+{
+public:
+    be_bit_writer(
+        void* buf,
+        size_t bytes
+    )
+    noexcept:
+        first_(reinterpret_cast<unsigned char*>(buf)),
+        ptr_(first_),
+        last_(first_ + bytes)
+    {}
+
+    /**
+     *  \brief Write the low `n` bits of `value`, for `n` in [1, 57].
+     */
+    void
+    write(
+        uint64_t value,
+        unsigned n
+    )
+    noexcept
+    {
+        value &= (uint64_t(1) << n) - 1;
+        bitbuf_ = (bitbuf_ << n) | value;
+        bitcount_ += n;
+        size_t bytes = bitcount_ >> 3;
+        if (last_ - ptr_ >= 8) {
+            store_be64(ptr_, bitbuf_ << (64 - bitcount_));
+            ptr_ += bytes;
+        } else {
+            store_tail(bytes);
+        }
+        bitcount_ &= 7;
+    }
+
+    /**
+     *  \brief Pad to the next byte boundary with zero bits.
+     */
+    void
+    align()
+    noexcept
+    {
+        if (bitcount_ != 0) {
+            write(0, 8 - bitcount_);
+        }
+    }
+
+    /**
+     *  \brief Pad the final byte with zero bits, and return the number
+     *  of bytes written.
+     */
+    size_t
+    flush()
+    noexcept
+    {
+        align();
+        return size();
+    }
+
+    /**
+     *  \brief Number of whole bytes written.
+     */
+    size_t
+    size()
+    const noexcept
+    {
+        return static_cast<size_t>(ptr_ - first_);
+    }
+
+    /**
+     *  \brief Number of bits written, including a partial final byte.
+     */
+    size_t
+    position()
+    const noexcept
+    {
+        return size() * 8 + bitcount_;
+    }
+
+    /**
+     *  \brief Whether writes were dropped for lack of room.
+     */
+    bool
+    overflow()
+    const noexcept
+    {
+        return overflow_;
+    }
+
+private:
+    void
+    store_tail(
+        size_t bytes
+    )
+    noexcept
+    {
+        // The partial final byte is rewritten by the next store, and
+        // only needs room once it is complete.
+        unsigned char tail[8];
+        store_be64(tail, bitbuf_ << (64 - bitcount_));
+        size_t room = static_cast<size_t>(last_ - ptr_);
+        size_t count = std::min(room, bytes + ((bitcount_ & 7) != 0));
+        if (count != 0) {
+            std::memcpy(ptr_, tail, count);
+        }
+        if (bytes > room) {
+            overflow_ = true;
+            bytes = room;
+        }
+        ptr_ += bytes;
+    }
+
+    unsigned char* first_;
+    unsigned char* ptr_;
+    unsigned char* last_;
+    uint64_t bitbuf_ = 0;
+    unsigned bitcount_ = 0;
+    bool overflow_ = false;
+};
+
+}   /* pycpp */
+
+
+#if BYTE_ORDER == LITTLE_ENDIAN
+
+#   define htobe(buf, i) bswap(buf, i)
+#   define htole(buf, i)
+#   define betoh(buf, i) bswap(buf, i)
+#   define letoh(buf, i)
+
+#   define memcpy_htobe16(dst, src, n) memcpy_bswap16(dst, src, n)
+#   define memcpy_htole16(dst, src, n) memcpy(dst, src, n)
+#   define memcpy_be16toh(dst, src, n) memcpy_bswap16(dst, src, n)
+#   define memcpy_le16toh(dst, src, n) memcpy(dst, src, n)
+
+#   define memcpy_htobe32(dst, src, n) memcpy_bswap32(dst, src, n)
+#   define memcpy_htole32(dst, src, n) memcpy(dst, src, n)
+#   define memcpy_be32toh(dst, src, n) memcpy_bswap32(dst, src, n)
+#   define memcpy_le32toh(dst, src, n) memcpy(dst, src, n)
 
 #   define memcpy_htobe64(dst, src, n) memcpy_bswap64(dst, src, n)
 #   define memcpy_htole64(dst, src, n) memcpy(dst, src, n)
 #   define memcpy_be64toh(dst, src, n) memcpy_bswap64(dst, src, n)
 #   define memcpy_le64toh(dst, src, n) memcpy(dst, src, n)
 
+#   define memcpy_htobe24(dst, src, n) memcpy_bswap24(dst, src, n)
+#   define memcpy_htole24(dst, src, n) memcpy(dst, src, n)
+#   define memcpy_be24toh(dst, src, n) memcpy_bswap24(dst, src, n)
+#   define memcpy_le24toh(dst, src, n) memcpy(dst, src, n)
+
+#   define memcpy_htobe128(dst, src, n) memcpy_bswap128(dst, src, n)
+#   define memcpy_htole128(dst, src, n) memcpy(dst, src, n)
+#   define memcpy_be128toh(dst, src, n) memcpy_bswap128(dst, src, n)
+#   define memcpy_le128toh(dst, src, n) memcpy(dst, src, n)
+
 #   define memcpy_htobe(dst, src, n, i) memcpy_bswap(dst, src, n, i)
 #   define memcpy_htole(dst, src, n, i) memcpy(dst, src, n)
 #   define memcpy_betoh(dst, src, n, i) memcpy_bswap(dst, src, n, i)
 #   define memcpy_letoh(dst, src, n, i) memcpy(dst, src, n)
 
+#   define htobe16_inplace(buf, n) bswap_inplace16(buf, n)
+#   define htole16_inplace(buf, n)
+#   define be16toh_inplace(buf, n) bswap_inplace16(buf, n)
+#   define le16toh_inplace(buf, n)
+
+#   define htobe32_inplace(buf, n) bswap_inplace32(buf, n)
+#   define htole32_inplace(buf, n)
+#   define be32toh_inplace(buf, n) bswap_inplace32(buf, n)
+#   define le32toh_inplace(buf, n)
+
+#   define htobe64_inplace(buf, n) bswap_inplace64(buf, n)
+#   define htole64_inplace(buf, n)
+#   define be64toh_inplace(buf, n) bswap_inplace64(buf, n)
+#   define le64toh_inplace(buf, n)
+
+#   define htobe24_inplace(buf, n) bswap_inplace24(buf, n)
+#   define htole24_inplace(buf, n)
+#   define be24toh_inplace(buf, n) bswap_inplace24(buf, n)
+#   define le24toh_inplace(buf, n)
+
+#   define htobe128_inplace(buf, n) bswap_inplace128(buf, n)
+#   define htole128_inplace(buf, n)
+#   define be128toh_inplace(buf, n) bswap_inplace128(buf, n)
+#   define le128toh_inplace(buf, n)
+
+#   define htobe_inplace(buf, n, i) bswap_inplace(buf, n, i)
+#   define htole_inplace(buf, n, i)
+#   define betoh_inplace(buf, n, i) bswap_inplace(buf, n, i)
+#   define letoh_inplace(buf, n, i)
+
 #elif BYTE_ORDER == BIG_ENDIAN
 
 #   define htobe(buf, i)
@@ -347,46 +2673,54 @@ noexcept;
 #   define memcpy_be64toh(dst, src, n) memcpy(dst, src, n)
 #   define memcpy_le64toh(dst, src, n) memcpy_bswap64(dst, src, n)
 
+#   define memcpy_htobe24(dst, src, n) memcpy(dst, src, n)
+#   define memcpy_htole24(dst, src, n) memcpy_bswap24(dst, src, n)
+#   define memcpy_be24toh(dst, src, n) memcpy(dst, src, n)
+#   define memcpy_le24toh(dst, src, n) memcpy_bswap24(dst, src, n)
+
+#   define memcpy_htobe128(dst, src, n) memcpy(dst, src, n)
+#   define memcpy_htole128(dst, src, n) memcpy_bswap128(dst, src, n)
+#   define memcpy_be128toh(dst, src, n) memcpy(dst, src, n)
+#   define memcpy_le128toh(dst, src, n) memcpy_bswap128(dst, src, n)
+
 #   define memcpy_htobe(dst, src, n, i) memcpy(dst, src, n)
 #   define memcpy_htole(dst, src, n, i) memcpy_bswap(dst, src, n, i)
 #   define memcpy_betoh(dst, src, n, i) memcpy(dst, src, n)
 #   define memcpy_letoh(dst, src, n, i) memcpy_bswap(dst, src, n, i)
 
-#else
+#   define htobe16_inplace(buf, n)
+#   define htole16_inplace(buf, n) bswap_inplace16(buf, n)
+#   define be16toh_inplace(buf, n)
+#   define le16toh_inplace(buf, n) bswap_inplace16(buf, n)
 
-#   error "Byte order not supported."
+#   define htobe32_inplace(buf, n)
+#   define htole32_inplace(buf, n) bswap_inplace32(buf, n)
+#   define be32toh_inplace(buf, n)
+#   define le32toh_inplace(buf, n) bswap_inplace32(buf, n)
 
-#endif
+#   define htobe64_inplace(buf, n)
+#   define htole64_inplace(buf, n) bswap_inplace64(buf, n)
+#   define be64toh_inplace(buf, n)
+#   define le64toh_inplace(buf, n) bswap_inplace64(buf, n)
 
+#   define htobe24_inplace(buf, n)
+#   define htole24_inplace(buf, n) bswap_inplace24(buf, n)
+#   define be24toh_inplace(buf, n)
+#   define le24toh_inplace(buf, n) bswap_inplace24(buf, n)
 
-#if defined(NEED_BSWAPXX)
-#   include <cstdint>
+#   define htobe128_inplace(buf, n)
+#   define htole128_inplace(buf, n) bswap_inplace128(buf, n)
+#   define be128toh_inplace(buf, n)
+#   define le128toh_inplace(buf, n) bswap_inplace128(buf, n)
 
-/**
- *  \brief Swap 16-bit type in-place.
- */
-uint16_t
-bswap16(
-    uint16_t i
-)
-noexcept;
+#   define htobe_inplace(buf, n, i)
+#   define htole_inplace(buf, n, i) bswap_inplace(buf, n, i)
+#   define betoh_inplace(buf, n, i)
+#   define letoh_inplace(buf, n, i) bswap_inplace(buf, n, i)
 
-/**
- *  \brief Swap 32-bit type in-place.
- */
-uint32_t
-bswap32(
-    uint32_t i
-)
-noexcept;
+#else
 
-/**
- *  \brief Swap 64-bit type in-place.
- */
-uint64_t
-bswap64(
-    uint64_t i
-)
-noexcept;
+#   error "Byte order not supported."
 
 #endif
+
@@ -867,17 +867,17 @@
 
 // Check if we have a POSIX-like system.
 #if defined(PYCPP_OS_DETECTED)
-#   if defined(OS_LINUX) || defined(OS_MACOS) || defined(PYCPP_BSD) || \
-        defined(OS_SOLARIS) || defined(OS_IRIX) || defined(OS_HPUX) || \
-        defined(PYCPP_CYGWIN) || defined(PYCPP_AIX) || defined(OS_QNX) || \
-        defined(OS_VMS) || defined(OS_ULTRIX) || defined(OS_RELIANT) || \
-        defined(OS_DYNIX) || defined(OS_EMX) || defined(OS_OSF) || \
-        defined(OS_DGUX) || defined(OS_LYNX) || defined(OS_SCO) || \
-        defined(OS_HURD) || defined(OS_UNIXWARE) || defined(AMDAHL) || \
-        defined(PYCPP_AEGIS) || defined(PYCPP_APOLLO) || defined(OS_MINIX) || \
-        defined(OS_MPEIX) || defined(OS_VOS) || defined(OS_SVR4) || \
-        defined(OS_UNICOS) || defined(OS_UNICOSMP) || defined(OS_ZOS) || \
-        defined(OS_UNIX)
+#   if defined(PYCPP_OS_LINUX) || defined(PYCPP_OS_MACOS) || defined(PYCPP_BSD) || \
+        defined(PYCPP_OS_SOLARIS) || defined(PYCPP_OS_IRIX) || defined(PYCPP_OS_HPUX) || \
+        defined(PYCPP_CYGWIN) || defined(PYCPP_AIX) || defined(PYCPP_OS_QNX) || \
+        defined(PYCPP_OS_VMS) || defined(PYCPP_OS_ULTRIX) || defined(PYCPP_OS_RELIANT) || \
+        defined(PYCPP_OS_DYNIX) || defined(PYCPP_OS_EMX) || defined(PYCPP_OS_OSF) || \
+        defined(PYCPP_OS_DGUX) || defined(PYCPP_OS_LYNX) || defined(PYCPP_OS_SCO) || \
+        defined(PYCPP_OS_HURD) || defined(PYCPP_OS_UNIXWARE) || defined(PYCPP_AMDAHL) || \
+        defined(PYCPP_AEGIS) || defined(PYCPP_APOLLO) || defined(PYCPP_OS_MINIX) || \
+        defined(PYCPP_OS_MPEIX) || defined(PYCPP_OS_VOS) || defined(PYCPP_OS_SVR4) || \
+        defined(PYCPP_OS_UNICOS) || defined(PYCPP_OS_UNICOSMP) || defined(PYCPP_OS_ZOS) || \
+        defined(PYCPP_OS_UNIX)
 #       define PYCPP_OS_POSIX
 #   endif
 #endif